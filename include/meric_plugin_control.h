@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+/*
+ * Control the sampler of the meric plugin from the instrumented application.
+ *
+ * The plugin is loaded by Score-P at runtime, so applications usually resolve these
+ * functions with `dlsym( RTLD_DEFAULT, "meric_plugin_burst_begin" )` instead of
+ * linking against the plugin library directly.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Switch the sampler to `interval_us` for `duration_us` microseconds.
+ * If `duration_us` is 0, the burst lasts until meric_plugin_burst_end() is called.
+ * Returns 0 on success, and -1 if no measurement is running or the interval is zero or
+ * longer than the sampler allows, e.g. so long that counters could wrap unnoticed.
+ */
+int
+meric_plugin_burst_begin( unsigned long interval_us,
+                          unsigned long duration_us );
+
+/*
+ * End a burst started with meric_plugin_burst_begin() and return to the base interval.
+ * Returns 0 on success, and -1 if no measurement is running.
+ */
+int
+meric_plugin_burst_end( void );
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace MericPlugin
+{
+/*
+ * Compact columnar side-car file with the raw samples of one host.
+ *
+ * Layout, all offsets relative to the start of the file and 64-byte aligned:
+ *
+ *     SidecarFormat::Header
+ *     SidecarFormat::MetricEntry * num_metrics
+ *     uint64_t * num_samples                           Score-P timestamps (ticks)
+ *     double * num_samples, column_stride apart       one column per metric, in its unit
+ *
+ * Values in J are the energy consumed since the previous sample of the same metric, the
+ * PLUGIN and EFF metrics hold one value per sample in their own unit, e.g. s or MHz.
+ * Samples without a reading of a metric are NaN.
+ */
+namespace SidecarFormat
+{
+constexpr char          magic[ 8 ] = { 'M', 'E', 'R', 'I', 'C', 'S', 'C', '\0' };
+constexpr std::uint32_t version    = 1;
+
+struct Header
+{
+    char          magic[ 8 ];
+    std::uint32_t version;
+    std::uint32_t num_metrics;
+    std::uint64_t num_samples;
+    std::uint64_t metrics_offset;
+    std::uint64_t timestamps_offset;
+    std::uint64_t values_offset;
+    std::uint64_t column_stride;
+    // Score-P ticks and CLOCK_REALTIME nanoseconds taken together at the begin
+    // and the end of the measurement, to convert timestamps to wall-clock time
+    std::uint64_t calibration_ticks[ 2 ];
+    std::uint64_t calibration_realtime_ns[ 2 ];
+    char          hostname[ 64 ];
+};
+
+struct MetricEntry
+{
+    char name[ 64 ];
+    char unit[ 16 ];
+};
+}
+
+
+// A read-only view into contiguous memory
+template <typename T>
+struct Span
+{
+    const T*    data;
+    std::size_t size;
+
+    const T*
+    begin() const
+    {
+        return data;
+    }
+
+    const T*
+    end() const
+    {
+        return data + size;
+    }
+
+    const T&
+    operator[]( std::size_t i ) const
+    {
+        return data[ i ];
+    }
+};
+
+
+// Memory-maps a side-car file. All spans point directly into the mapping.
+class SidecarReader
+{
+public:
+    explicit SidecarReader( const std::string& path );
+
+    ~SidecarReader();
+
+    SidecarReader( const SidecarReader& ) = delete;
+    SidecarReader&
+    operator=( const SidecarReader& ) = delete;
+
+    std::size_t
+    num_metrics() const;
+
+    std::size_t
+    num_samples() const;
+
+    std::string
+    hostname() const;
+
+    const std::vector<std::string>&
+    metric_names() const
+    {
+        return names;
+    }
+
+    std::string
+    unit( std::size_t metric ) const;
+
+    // Index of the metric with the given name, or -1
+    long
+    find_metric( const std::string& name ) const;
+
+    Span<std::uint64_t>
+    timestamps() const;
+
+    Span<double>
+    values( std::size_t metric ) const;
+
+    // Convert a Score-P timestamp to seconds since the Unix epoch
+    double
+    to_realtime_seconds( std::uint64_t ticks ) const;
+
+private:
+    std::size_t                  size;
+    const unsigned char*         memory;
+    const SidecarFormat::Header* header;
+    std::vector<std::string>     names;
+};
+
+
+struct IntervalStats
+{
+    double      begin_s;    // Relative to the first sample
+    double      end_s;
+    double      energy_j;   // Metrics in J only, NaN for other units
+    double      mean_power_w;
+    double      peak_power_w;
+    double      mean_value; // Metrics in other units only, NaN for J
+    double      peak_value;
+    std::size_t samples;    // Samples with a value
+};
+
+// Energy and power of one metric in consecutive windows of `window_s` seconds, or the
+// mean and peak value per sample for metrics that are not in J. NaN values are skipped,
+// and so are samples stamped before the first one. The mean power is over the time the
+// samples of a window cover, so a partial last window is not diluted.
+std::vector<IntervalStats>
+interval_stats( const SidecarReader& reader,
+                std::size_t          metric,
+                double               window_s );
+
+// interval_stats() for all metrics, computed with up to `num_threads` threads
+std::vector<std::vector<IntervalStats> >
+interval_stats( const SidecarReader& reader,
+                double               window_s,
+                unsigned int         num_threads );
+}
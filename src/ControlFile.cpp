@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "ControlFile.h"
+#include "utils.h"
+
+#include <scorep/plugin/log.hpp>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+
+using scorep::plugin::logging;
+
+namespace MericPlugin
+{
+ControlFile::ControlFile( std::string path, Callback callback ) :
+    path( std::move( path ) ),
+    callback( std::move( callback ) )
+{
+    // Editors replace files instead of writing them, so the directory is watched
+    const auto        slash     = this->path.rfind( '/' );
+    const std::string directory = slash == std::string::npos ? "." : this->path.substr( 0, std::max<std::size_t>( slash, 1 ) );
+    file_name = slash == std::string::npos ? this->path : this->path.substr( slash + 1 );
+
+    inotify_fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+    if ( inotify_fd < 0 || inotify_add_watch( inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO ) < 0
+         || pipe2( stop_pipe, O_CLOEXEC ) != 0 )
+    {
+        const std::string error = std::strerror( errno );
+        if ( inotify_fd >= 0 )
+        {
+            close( inotify_fd );
+        }
+        throw std::runtime_error( "Cannot watch " + directory + ": " + error );
+    }
+    // A file that exists already is applied right away
+    std::ifstream in( this->path );
+    if ( in )
+    {
+        this->callback( parse( in ) );
+    }
+    thread = std::thread( [ this ](){
+            this->watch();
+        } );
+}
+
+
+ControlFile::~ControlFile()
+{
+    const char stop = 0;
+    if ( write( stop_pipe[ 1 ], &stop, 1 ) != 1 )
+    {
+        logging::warn() << "Cannot stop the control file watcher";
+    }
+    thread.join();
+    close( stop_pipe[ 0 ] );
+    close( stop_pipe[ 1 ] );
+    close( inotify_fd );
+}
+
+
+ControlFile::Settings
+ControlFile::parse( std::istream& in )
+{
+    Settings    settings;
+    std::string line;
+    while ( std::getline( in, line ) )
+    {
+        if ( line == "" || line[ 0 ] == '#' )
+        {
+            continue;
+        }
+        const auto        equals = line.find( '=' );
+        const std::string key    = line.substr( 0, equals );
+        const std::string value  = equals == std::string::npos ? "" : line.substr( equals + 1 );
+        try
+        {
+            if ( key == "interval" && value != "" )
+            {
+                settings.interval = parse_duration( value );
+                if ( settings.interval.count() == 0 )
+                {
+                    throw std::invalid_argument( "The interval must be positive" );
+                }
+                settings.has_interval = true;
+            }
+            else if ( key == "domains" && value != "" )
+            {
+                settings.domains     = value == "ALL" ? std::vector<std::string>() : split_string( value, ',' );
+                settings.has_domains = true;
+            }
+            else if ( key == "burst" && value == "off" )
+            {
+                settings.burst     = false;
+                settings.has_burst = true;
+            }
+            else if ( key == "burst" && value.find( ':' ) != std::string::npos )
+            {
+                const auto colon = value.find( ':' );
+                settings.burst_interval = parse_duration( value.substr( 0, colon ) );
+                settings.burst_duration = parse_duration( value.substr( colon + 1 ) );
+                if ( settings.burst_interval.count() == 0 )
+                {
+                    throw std::invalid_argument( "The burst interval must be positive" );
+                }
+                settings.burst     = true;
+                settings.has_burst = true;
+            }
+            else
+            {
+                throw std::invalid_argument( "Unknown setting" );
+            }
+        }
+        catch ( const std::invalid_argument& e )
+        {
+            logging::warn() << "Ignoring control line '" << line << "': " << e.what();
+        }
+    }
+    return settings;
+}
+
+
+void
+ControlFile::watch()
+{
+    pollfd fds[ 2 ] = { { inotify_fd, POLLIN, 0 }, { stop_pipe[ 0 ], POLLIN, 0 } };
+    alignas( inotify_event ) char buffer[ 4096 ];
+    while ( poll( fds, 2, -1 ) >= 0 || errno == EINTR )
+    {
+        if ( fds[ 1 ].revents )
+        {
+            return;
+        }
+        bool changed = false;
+        for ( ssize_t length; ( length = read( inotify_fd, buffer, sizeof( buffer ) ) ) > 0; )
+        {
+            for ( char* pos = buffer; pos < buffer + length; )
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>( pos );
+                changed = changed || ( event->len > 0 && file_name == event->name );
+                pos    += sizeof( inotify_event ) + event->len;
+            }
+        }
+        if ( changed )
+        {
+            std::ifstream in( path );
+            if ( in )
+            {
+                callback( parse( in ) );
+            }
+        }
+    }
+}
+}
@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <istream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace MericPlugin
+{
+/*
+ * A control file to reconfigure a running measurement, watched with inotify.
+ *
+ * Each time the file is written or replaced, its lines are parsed and passed to the
+ * callback, in the thread of the watcher. Lines are <key>=<value>, keys that are not
+ * given keep their setting:
+ *
+ *     interval=<duration>                  regular sampling interval, e.g. 10ms
+ *     domains=<domain>,...|ALL             domains whose metrics are recorded
+ *     burst=<interval>:<duration>|off      burst sampling, a zero duration lasts until off
+ *
+ * Empty lines and lines starting with '#' are ignored.
+ */
+class ControlFile
+{
+public:
+    struct Settings
+    {
+        bool                      has_interval = false;
+        std::chrono::microseconds interval;
+        bool                      has_domains = false;
+        std::vector<std::string>  domains; // Empty for ALL
+        bool                      has_burst = false;
+        bool                      burst     = false;
+        std::chrono::microseconds burst_interval;
+        std::chrono::microseconds burst_duration;
+    };
+
+    using Callback = std::function<void( const Settings& )>;
+
+    // Applies the file if it exists already. Throws std::runtime_error if the directory
+    // of `path` cannot be watched.
+    ControlFile( std::string path,
+                 Callback    callback );
+
+    ~ControlFile();
+
+    ControlFile( const ControlFile& ) = delete;
+
+    ControlFile&
+    operator=( const ControlFile& ) = delete;
+
+    // Invalid lines are skipped with a warning
+    static Settings
+    parse( std::istream& in );
+
+private:
+    void
+    watch();
+
+    std::string path;
+    std::string file_name;
+    Callback    callback;
+    int         inotify_fd = -1;
+    int         stop_pipe[ 2 ];
+    std::thread thread;
+};
+}
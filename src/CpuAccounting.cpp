@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "CpuAccounting.h"
+
+#include <scorep/plugin/log.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+
+using scorep::plugin::logging;
+
+namespace MericPlugin
+{
+// The cgroup v2 path of this process, from the "0::<path>" line of /proc/self/cgroup
+static std::string
+cgroup_path( const std::string& proc_root )
+{
+    std::ifstream in( proc_root + "/self/cgroup" );
+    std::string   line;
+    while ( std::getline( in, line ) )
+    {
+        if ( line.compare( 0, 3, "0::" ) == 0 )
+        {
+            return line.substr( 3 );
+        }
+    }
+    return "";
+}
+
+
+CpuAccounting::CpuAccounting( Scope scope, const std::string& proc_root, const std::string& cgroup_root ) :
+    _scope( scope ),
+    ticks_per_second( sysconf( _SC_CLK_TCK ) )
+{
+    node_fd = open( ( proc_root + "/stat" ).c_str(), O_RDONLY | O_CLOEXEC );
+    if ( node_fd < 0 )
+    {
+        throw std::runtime_error( "Cannot read " + proc_root + "/stat" );
+    }
+    if ( _scope == Scope::cgroup )
+    {
+        const std::string path = cgroup_path( proc_root );
+        if ( path != "" )
+        {
+            scope_fd = open( ( cgroup_root + path + "/cpu.stat" ).c_str(), O_RDONLY | O_CLOEXEC );
+        }
+        if ( scope_fd < 0 )
+        {
+            logging::warn() << "Cannot read the cgroup v2 CPU time of this process, attributing energy to this process only";
+            _scope = Scope::process;
+        }
+    }
+    if ( _scope == Scope::process )
+    {
+        scope_fd = open( ( proc_root + "/self/stat" ).c_str(), O_RDONLY | O_CLOEXEC );
+        if ( scope_fd < 0 )
+        {
+            close( node_fd );
+            throw std::runtime_error( "Cannot read " + proc_root + "/self/stat" );
+        }
+    }
+    prev_node  = node_seconds();
+    prev_scope = scope_seconds();
+}
+
+
+CpuAccounting::~CpuAccounting()
+{
+    close( node_fd );
+    close( scope_fd );
+}
+
+
+std::size_t
+CpuAccounting::read_file( int fd )
+{
+    const ssize_t length = pread( fd, buffer, sizeof( buffer ) - 1, 0 );
+    buffer[ length > 0 ? length : 0 ] = '\0';
+    return length > 0 ? length : 0;
+}
+
+
+double
+CpuAccounting::node_seconds()
+{
+    // cpu  user nice system idle iowait irq softirq steal guest guest_nice, in clock ticks
+    read_file( node_fd );
+    if ( std::strncmp( buffer, "cpu ", 4 ) != 0 )
+    {
+        return prev_node;
+    }
+    char*              pos = buffer + 4;
+    unsigned long long busy = 0;
+    for ( int field = 0; field < 8; ++field )
+    {
+        const unsigned long long value = std::strtoull( pos, &pos, 10 );
+        if ( field != 3 && field != 4 ) // Not idle or iowait
+        {
+            busy += value;
+        }
+    }
+    return busy / ticks_per_second;
+}
+
+
+double
+CpuAccounting::scope_seconds()
+{
+    read_file( scope_fd );
+    if ( _scope == Scope::cgroup )
+    {
+        const char* usage = std::strstr( buffer, "usage_usec " );
+        return usage ? std::strtoull( usage + 11, nullptr, 10 ) * 1e-6 : prev_scope;
+    }
+    // Fields after the command name, which may contain spaces: state is field 3, utime 14, stime 15
+    char* pos = std::strrchr( buffer, ')' );
+    if ( !pos )
+    {
+        return prev_scope;
+    }
+    pos += 2;
+    for ( int field = 3; field < 14; ++field )
+    {
+        pos = std::strchr( pos, ' ' );
+        if ( !pos )
+        {
+            return prev_scope;
+        }
+        ++pos;
+    }
+    const unsigned long long utime = std::strtoull( pos, &pos, 10 );
+    const unsigned long long stime = std::strtoull( pos, &pos, 10 );
+    return ( utime + stime ) / ticks_per_second;
+}
+
+
+double
+CpuAccounting::share()
+{
+    const double node  = node_seconds();
+    const double scope = scope_seconds();
+    // The node counters tick with a coarse granularity, keep the last share without progress
+    if ( node > prev_node )
+    {
+        prev_share = std::min( 1., std::max( 0., ( scope - prev_scope ) / ( node - prev_node ) ) );
+        prev_node  = node;
+        prev_scope = scope;
+    }
+    return prev_share;
+}
+}
@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include <string>
+
+
+namespace MericPlugin
+{
+/*
+ * CPU time of the traced processes against the busy CPU time of the whole node, to
+ * attribute a share of the package energy to them.
+ *
+ * The traced processes are either the cgroup of this process, which holds all processes
+ * of a job step on a node with Slurm and cgroup v2, or this process alone. The files are
+ * kept open and re-read with pread, so a call costs a few microseconds.
+ */
+class CpuAccounting
+{
+public:
+    enum class Scope
+    {
+        cgroup,
+        process
+    };
+
+    // Falls back to Scope::process if the cgroup cannot be read. Throws std::runtime_error
+    // if the CPU time of the node or the process cannot be read.
+    CpuAccounting( Scope              scope,
+                   const std::string& proc_root = "/proc",
+                   const std::string& cgroup_root = "/sys/fs/cgroup" );
+
+    ~CpuAccounting();
+
+    CpuAccounting( const CpuAccounting& ) = delete;
+
+    CpuAccounting&
+    operator=( const CpuAccounting& ) = delete;
+
+    // Share of the busy CPU time of the node used by the traced processes since the
+    // previous call, in [0, 1]
+    double
+    share();
+
+    Scope
+    scope() const
+    {
+        return _scope;
+    }
+
+private:
+    // Busy CPU time of all CPUs from the first line of /proc/stat, in s
+    double
+    node_seconds();
+
+    // CPU time of the traced processes, in s
+    double
+    scope_seconds();
+
+    // Reads the start of a file into buffer, returns its length
+    std::size_t
+    read_file( int fd );
+
+    Scope  _scope;
+    int    node_fd  = -1;
+    int    scope_fd = -1;
+    double ticks_per_second;
+    double prev_node  = 0.;
+    double prev_scope = 0.;
+    double prev_share = 0.;
+    char   buffer[ 4096 ];
+};
+}
@@ -0,0 +1,197 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "DeviceFilter.h"
+#include "utils.h"
+
+#include <scorep/plugin/log.hpp>
+
+#include <cctype>
+#include <cstdlib>
+
+
+using scorep::plugin::logging;
+
+namespace MericPlugin
+{
+DeviceFilterBackend::DeviceFilterBackend( std::unique_ptr<EnergyBackend>&& backend, DeviceSets devices ) :
+    backend( std::move( backend ) ),
+    devices( std::move( devices ) )
+{
+}
+
+
+int
+DeviceFilterBackend::counter_device( const std::string& counter_name )
+{
+    auto begin = counter_name.size();
+    while ( begin > 0 && std::isdigit( static_cast<unsigned char>( counter_name[ begin - 1 ] ) ) )
+    {
+        --begin;
+    }
+    return begin == counter_name.size() ? -1 : std::stoi( counter_name.substr( begin ) );
+}
+
+
+// Device numbers of a comma-separated list, or an empty set if it holds UUIDs or names
+static std::set<unsigned int>
+parse_device_list( const std::string& list, const std::string& origin )
+{
+    std::set<unsigned int> result;
+    for ( const std::string& device : split_string( list, ',' ) )
+    {
+        if ( device.empty() || device.find_first_not_of( "0123456789" ) != std::string::npos )
+        {
+            logging::warn() << "Cannot map device '" << device << "' in " << origin << " to counters, not filtering by " << origin;
+            return {};
+        }
+        result.insert( std::stoul( device ) );
+    }
+    return result;
+}
+
+
+// Rank of this process on its node, as set by the common launchers
+static int
+local_rank()
+{
+    for ( const char* name : { "SLURM_LOCALID", "OMPI_COMM_WORLD_LOCAL_RANK", "MPI_LOCALRANKID", "PMI_LOCAL_RANK", "PALS_LOCAL_RANKID" } )
+    {
+        if ( const char* value = std::getenv( name ) )
+        {
+            return std::atoi( value );
+        }
+    }
+    return -1;
+}
+
+
+DeviceFilterBackend::DeviceSets
+DeviceFilterBackend::devices_from_environment( const std::string& explicit_devices )
+{
+    const unsigned int nvml = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_NVML;
+    const unsigned int rocm = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_ROCM;
+    DeviceSets         result;
+
+    if ( explicit_devices != "" )
+    {
+        std::string list = explicit_devices;
+        if ( explicit_devices.find( ':' ) != std::string::npos )
+        {
+            // Mapping <local rank>:<device>[+<device>...]
+            const int rank = local_rank();
+            list = "";
+            for ( const std::string& entry : split_string( explicit_devices, ',' ) )
+            {
+                const auto colon = entry.find( ':' );
+                if ( colon != std::string::npos && std::atoi( entry.substr( 0, colon ).c_str() ) == rank )
+                {
+                    list = join_strings( split_string( entry.substr( colon + 1 ), '+' ), "," );
+                }
+            }
+            if ( list == "" )
+            {
+                logging::warn() << "No devices are mapped to local rank " << rank << ", not filtering devices";
+                return result;
+            }
+        }
+        const auto device_set = parse_device_list( list, "DEVICES" );
+        if ( !device_set.empty() )
+        {
+            result[ nvml ] = device_set;
+            result[ rocm ] = device_set;
+        }
+        return result;
+    }
+
+    if ( const char* cuda = std::getenv( "CUDA_VISIBLE_DEVICES" ) )
+    {
+        const auto device_set = parse_device_list( cuda, "CUDA_VISIBLE_DEVICES" );
+        if ( !device_set.empty() )
+        {
+            result[ nvml ] = device_set;
+        }
+    }
+    const char* rocr = std::getenv( "ROCR_VISIBLE_DEVICES" );
+    const char* hip  = std::getenv( "HIP_VISIBLE_DEVICES" );
+    if ( rocr || hip )
+    {
+        const auto device_set = parse_device_list( rocr ? rocr : hip, rocr ? "ROCR_VISIBLE_DEVICES" : "HIP_VISIBLE_DEVICES" );
+        if ( !device_set.empty() )
+        {
+            result[ rocm ] = device_set;
+        }
+    }
+    return result;
+}
+
+
+std::unordered_map<std::string, Domain>
+DeviceFilterBackend::query_enabled_domains()
+{
+    auto domains = backend->query_enabled_domains();
+    kept_counters.clear();
+    enabled_domain_idx.clear();
+    for ( auto& it : domains )
+    {
+        Domain& domain = it.second;
+        enabled_domain_idx.push_back( domain.idx );
+        const auto devices_it = devices.find( domain.id );
+        if ( devices_it == devices.end() )
+        {
+            continue;
+        }
+        auto& kept = kept_counters[ domain.idx ];
+        for ( auto counter = domain.counter_idx_by_name.begin(); counter != domain.counter_idx_by_name.end(); )
+        {
+            const int device = counter_device( counter->first );
+            if ( device >= 0 && devices_it->second.count( device ) == 0 )
+            {
+                counter = domain.counter_idx_by_name.erase( counter );
+            }
+            else
+            {
+                kept.push_back( counter->second );
+                ++counter;
+            }
+        }
+        logging::info() << "Domain " << it.first << " restricted to the counters " << domain.counter_names();
+    }
+    return domains;
+}
+
+
+void
+DeviceFilterBackend::read( EnergyReading& reading )
+{
+    backend->read( reading );
+    if ( kept_counters.empty() )
+    {
+        return;
+    }
+    for ( const auto& it : kept_counters )
+    {
+        auto& domain = reading.domain_data[ it.first ];
+        domain.energy_total = 0.;
+        for ( unsigned int counter : it.second )
+        {
+            domain.energy_total += domain.energy_per_counter[ counter ];
+        }
+    }
+    reading.energy_total = 0.;
+    for ( unsigned int idx : enabled_domain_idx )
+    {
+        reading.energy_total += reading.domain_data[ idx ].energy_total;
+    }
+}
+
+
+void
+DeviceFilterBackend::calc_energy_consumption( const EnergyReading& begin, const EnergyReading& end, EnergyReading& result ) const
+{
+    backend->calc_energy_consumption( begin, end, result );
+}
+}
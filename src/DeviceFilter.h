@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include "EnergyBackend.h"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace MericPlugin
+{
+/*
+ * Restricts the counters of GPU domains to the devices of this process.
+ *
+ * A counter belongs to the device given by the trailing number of its name, e.g. GPU_1;
+ * counters without a number are kept. The totals of a filtered domain, and the total of
+ * all domains, only sum up the kept counters.
+ */
+class DeviceFilterBackend : public EnergyBackend
+{
+public:
+    using DeviceSets = std::map<unsigned int, std::set<unsigned int> >; // Devices by domain id
+
+    DeviceFilterBackend( std::unique_ptr<EnergyBackend>&& backend,
+                         DeviceSets                       devices );
+
+    std::unordered_map<std::string, Domain>
+    query_enabled_domains() override;
+
+    void
+    read( EnergyReading& reading ) override;
+
+    void
+    calc_energy_consumption( const EnergyReading& begin,
+                             const EnergyReading& end,
+                             EnergyReading&       result ) const override;
+
+    std::chrono::microseconds
+    max_safe_interval() const override
+    {
+        return backend->max_safe_interval();
+    }
+
+    /*
+     * The devices of this process per GPU domain. An explicit list, e.g. "0,1", or a
+     * mapping by node-local rank, e.g. "0:0,1:1,2:2+3", applies to all GPU domains.
+     * Otherwise, NVML uses CUDA_VISIBLE_DEVICES and ROCM uses ROCR_VISIBLE_DEVICES or
+     * HIP_VISIBLE_DEVICES. Domains without a device list are not filtered.
+     */
+    static DeviceSets
+    devices_from_environment( const std::string& explicit_devices );
+
+    // The device number at the end of a counter name, or -1
+    static int
+    counter_device( const std::string& counter_name );
+
+private:
+    std::unique_ptr<EnergyBackend> backend;
+    DeviceSets                     devices;
+    // Kept counter indices by domain index, for the filtered domains
+    std::map<unsigned int, std::vector<unsigned int> > kept_counters;
+    std::vector<unsigned int>                          enabled_domain_idx;
+};
+}
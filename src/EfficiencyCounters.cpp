@@ -0,0 +1,236 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "EfficiencyCounters.h"
+
+#include <scorep/plugin/log.hpp>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+
+using scorep::plugin::logging;
+
+namespace MericPlugin
+{
+static int
+perf_event_open( perf_event_attr& attr, int cpu, int group_fd )
+{
+    return syscall( SYS_perf_event_open, &attr, -1, cpu, group_fd, 0 );
+}
+
+
+static int
+open_counter( std::uint64_t config, int cpu, int group_fd )
+{
+    perf_event_attr attr;
+    std::memset( &attr, 0, sizeof( attr ) );
+    attr.size        = sizeof( attr );
+    attr.type        = PERF_TYPE_HARDWARE;
+    attr.config      = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return perf_event_open( attr, cpu, group_fd );
+}
+
+
+static double
+read_number( int fd )
+{
+    char          buffer[ 32 ];
+    const ssize_t n = pread( fd, buffer, sizeof( buffer ) - 1, 0 );
+    if ( n <= 0 )
+    {
+        return NAN;
+    }
+    buffer[ n ] = '\0';
+    return std::strtod( buffer, nullptr );
+}
+
+
+// CPUs that cannot be taken offline, like cpu0 on most systems, have no online file
+static bool
+is_online( const std::string& cpu_path )
+{
+    std::ifstream online( cpu_path + "/online" );
+    int           state = 1;
+    return !( online >> state ) || state != 0;
+}
+
+
+EfficiencyCounters::EfficiencyCounters( const std::string& sysfs_root, bool count_instructions )
+{
+    std::vector<unsigned int> cpu_ids;
+    if ( DIR* root = opendir( sysfs_root.c_str() ) )
+    {
+        while ( const dirent* entry = readdir( root ) )
+        {
+            char* end;
+            if ( std::strncmp( entry->d_name, "cpu", 3 ) == 0 && entry->d_name[ 3 ] != '\0' )
+            {
+                const unsigned long id = std::strtoul( entry->d_name + 3, &end, 10 );
+                if ( *end == '\0' )
+                {
+                    cpu_ids.push_back( id );
+                }
+            }
+        }
+        closedir( root );
+    }
+    std::sort( cpu_ids.begin(), cpu_ids.end() );
+
+    for ( const unsigned int id : cpu_ids )
+    {
+        const std::string path = sysfs_root + "/cpu" + std::to_string( id );
+        if ( !is_online( path ) )
+        {
+            continue;
+        }
+        std::ifstream package( path + "/topology/physical_package_id" );
+        unsigned int  socket = 0;
+        package >> socket;
+        // Without a cpufreq driver, the CPU still counts instructions
+        const int fd = open( ( path + "/cpufreq/scaling_cur_freq" ).c_str(), O_RDONLY | O_CLOEXEC );
+        cpus.push_back( { .freq_fd = fd, .socket = socket } );
+        if ( socket >= socket_cpus.size() )
+        {
+            socket_cpus.resize( socket + 1, 0 );
+            socket_freq_cpus.resize( socket + 1, 0 );
+        }
+        socket_cpus[ socket ]++;
+        if ( fd >= 0 )
+        {
+            socket_freq_cpus[ socket ]++;
+            freq_cpus++;
+        }
+
+        if ( count_instructions )
+        {
+            const int leader = open_counter( PERF_COUNT_HW_INSTRUCTIONS, id, -1 );
+            const int cycles = leader >= 0 ? open_counter( PERF_COUNT_HW_CPU_CYCLES, id, leader ) : -1;
+            if ( cycles < 0 )
+            {
+                logging::warn() << "Cannot count instructions on CPU " << id << ": " << std::strerror( errno )
+                                << ". Check /proc/sys/kernel/perf_event_paranoid";
+                if ( leader >= 0 )
+                {
+                    close( leader );
+                }
+                for ( const auto& group : groups )
+                {
+                    close( group.leader_fd );
+                    close( group.cycles_fd );
+                }
+                groups.clear();
+                count_instructions = false;
+                continue;
+            }
+            groups.push_back( { .leader_fd = leader, .cycles_fd = cycles, .instructions = 0, .cycles = 0 } );
+        }
+    }
+    if ( groups.empty() && freq_cpus == 0 )
+    {
+        logging::warn() << "No cycle counts and no cpufreq entries in " << sysfs_root << ", EFF:avg_MHz is not available";
+    }
+    else if ( groups.empty() )
+    {
+        logging::warn() << "Without cycle counts, EFF:avg_MHz is the cpufreq frequency at each sample, not the average over the interval";
+    }
+    socket_sum.resize( socket_cpus.size() );
+}
+
+
+EfficiencyCounters::~EfficiencyCounters()
+{
+    for ( const auto& cpu : cpus )
+    {
+        if ( cpu.freq_fd >= 0 )
+        {
+            close( cpu.freq_fd );
+        }
+    }
+    for ( const auto& group : groups )
+    {
+        close( group.leader_fd );
+        close( group.cycles_fd );
+    }
+}
+
+
+void
+EfficiencyCounters::read( EfficiencySample& sample, double duration, double energy )
+{
+    std::fill( socket_sum.begin(), socket_sum.end(), 0. );
+    sample.socket_MHz.resize( socket_sum.size() );
+    if ( groups.empty() )
+    {
+        read_cpufreq( sample );
+        sample.values[ EfficiencySample::Ginstr_per_s ] = NAN;
+        sample.values[ EfficiencySample::IPC ]          = NAN;
+        sample.values[ EfficiencySample::J_per_Ginstr ] = NAN;
+        return;
+    }
+    // PERF_FORMAT_GROUP: the number of events, then the value of each event
+    std::uint64_t instructions = 0;
+    std::uint64_t cycles       = 0;
+    for ( std::size_t cpu = 0; cpu < groups.size(); ++cpu )
+    {
+        auto&         group       = groups[ cpu ];
+        std::uint64_t values[ 3 ] = {};
+        if ( ::read( group.leader_fd, values, sizeof( values ) ) != sizeof( values ) )
+        {
+            continue;
+        }
+        instructions                    += values[ 1 ] - group.instructions;
+        cycles                          += values[ 2 ] - group.cycles;
+        socket_sum[ cpus[ cpu ].socket ] += values[ 2 ] - group.cycles;
+        group.instructions               = values[ 1 ];
+        group.cycles                     = values[ 2 ];
+    }
+    // Cycles per second over the interval. Halted cycles are not counted, so idle time lowers it.
+    for ( std::size_t socket = 0; socket < socket_sum.size(); ++socket )
+    {
+        sample.socket_MHz[ socket ] = duration > 0. && socket_cpus[ socket ] > 0 ? socket_sum[ socket ] / socket_cpus[ socket ] / duration * 1e-6 : NAN;
+    }
+    sample.values[ EfficiencySample::avg_MHz ] = duration > 0. ? double( cycles ) / groups.size() / duration * 1e-6 : NAN;
+
+    const double ginstr = instructions * 1e-9;
+    sample.values[ EfficiencySample::Ginstr_per_s ] = duration > 0. ? ginstr / duration : NAN;
+    sample.values[ EfficiencySample::IPC ]          = cycles > 0 ? double( instructions ) / cycles : NAN;
+    sample.values[ EfficiencySample::J_per_Ginstr ] = ginstr > 0. ? energy / ginstr : NAN;
+}
+
+
+void
+EfficiencyCounters::read_cpufreq( EfficiencySample& sample )
+{
+    double total_khz = 0.;
+    for ( const auto& cpu : cpus )
+    {
+        if ( cpu.freq_fd < 0 )
+        {
+            continue;
+        }
+        const double khz = read_number( cpu.freq_fd );
+        socket_sum[ cpu.socket ] += khz;
+        total_khz                += khz;
+    }
+    for ( std::size_t socket = 0; socket < socket_sum.size(); ++socket )
+    {
+        sample.socket_MHz[ socket ] = socket_freq_cpus[ socket ] > 0 ? socket_sum[ socket ] / socket_freq_cpus[ socket ] / 1000. : NAN;
+    }
+    sample.values[ EfficiencySample::avg_MHz ] = freq_cpus > 0 ? total_khz / freq_cpus / 1000. : NAN;
+}
+}
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include "Metric.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace MericPlugin
+{
+/*
+ * CPU frequency and retired instructions of the node, read by the sampler in the same
+ * iteration as the energy counters, for the EFF:<name> metrics.
+ *
+ * The instructions and cycles of all online CPUs are counted system-wide with one perf_event
+ * group per CPU, read with a single read() each, which needs perf_event_paranoid <= 0 or
+ * CAP_PERFMON. The frequency is the average number of cycles per second of the CPUs of each
+ * socket in the interval. Without cycle counts, it falls back to scaling_cur_freq in cpufreq
+ * sysfs at the time of the sample. All files are kept open and re-read with pread.
+ */
+class EfficiencyCounters
+{
+public:
+    // Without `count_instructions`, no perf events are opened, the instruction based
+    // metrics are NaN, and the frequency comes from cpufreq
+    explicit EfficiencyCounters( const std::string& sysfs_root = "/sys/devices/system/cpu",
+                                 bool               count_instructions = true );
+
+    ~EfficiencyCounters();
+
+    EfficiencyCounters( const EfficiencyCounters& ) = delete;
+
+    EfficiencyCounters&
+    operator=( const EfficiencyCounters& ) = delete;
+
+    // Number of sockets of the online CPUs, the EFF:avg_MHz_<socket> metrics
+    std::size_t
+    num_sockets() const
+    {
+        return socket_cpus.size();
+    }
+
+    bool
+    counts_instructions() const
+    {
+        return !groups.empty();
+    }
+
+    // Fills `sample` for the `duration` in s since the previous call, and `energy` J
+    // consumed in it. The first call only starts the instruction counts.
+    void
+    read( EfficiencySample& sample,
+          double            duration,
+          double            energy );
+
+private:
+    void
+    read_cpufreq( EfficiencySample& sample );
+
+    struct Cpu
+    {
+        int          freq_fd; // -1 without cpufreq
+        unsigned int socket;
+    };
+
+    struct Group
+    {
+        int           leader_fd; // Instructions
+        int           cycles_fd;
+        std::uint64_t instructions;
+        std::uint64_t cycles;
+    };
+
+    std::vector<Cpu>          cpus;
+    std::vector<unsigned int> socket_cpus;      // Number of online CPUs per socket
+    std::vector<unsigned int> socket_freq_cpus; // Of them with cpufreq
+    std::size_t               freq_cpus = 0;
+    std::vector<Group>        groups;           // One per CPU in the order of cpus, or none
+    std::vector<double>       socket_sum;       // Reused sum of cycles or kHz per socket
+};
+}
@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "EnergyBackend.h"
+#include "ExtlibWrapper.h"
+#include "RaplBackend.h"
+#include "Recording.h"
+#include "SimBackend.h"
+#include "utils.h"
+
+#include <stdexcept>
+
+
+namespace MericPlugin
+{
+const std::unordered_map<std::string, unsigned int> EnergyBackend::domain_id_by_name = {
+    { "A64FX", ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_A64FX },
+    { "RAPL",  ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_RAPL  },
+    { "NVML",  ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_NVML  },
+    { "ROCM",  ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_ROCM  },
+    { "HDEEM", ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_HDEEM },
+    { "HWMON", ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_HWMON }
+};
+
+
+const std::unordered_map<unsigned int, std::string> EnergyBackend::domain_name_by_id =
+    map_inverse<std::string, unsigned int>( EnergyBackend::domain_id_by_name );
+
+
+std::vector<std::string>
+EnergyBackend::all_domain_names()
+{
+    return map_keys( EnergyBackend::domain_id_by_name );
+}
+
+
+std::vector<unsigned int>
+EnergyBackend::all_domain_ids()
+{
+    return map_keys( EnergyBackend::domain_name_by_id );
+}
+
+
+void
+EnergyBackend::calc_energy_consumption( const EnergyReading& begin, const EnergyReading& end, EnergyReading& result ) const
+{
+    result.domain_data.resize( end.domain_data.size() );
+    for ( std::size_t domain = 0; domain < end.domain_data.size(); ++domain )
+    {
+        const auto& b = begin.domain_data[ domain ];
+        const auto& e = end.domain_data[ domain ];
+        auto&       r = result.domain_data[ domain ];
+        r.energy_total = e.energy_total - b.energy_total;
+        r.energy_per_counter.resize( e.energy_per_counter.size() );
+        for ( std::size_t counter = 0; counter < e.energy_per_counter.size(); ++counter )
+        {
+            r.energy_per_counter[ counter ] = e.energy_per_counter[ counter ] - b.energy_per_counter[ counter ];
+        }
+    }
+    result.energy_total = end.energy_total - begin.energy_total;
+}
+
+
+std::unique_ptr<EnergyBackend>
+make_backend( const std::string& name, const std::vector<unsigned int>& requested_domains )
+{
+    if ( name == "extlib" )
+    {
+        return std::unique_ptr<EnergyBackend>( new ExtlibWrapper( requested_domains ) );
+    }
+    if ( name == "rapl" )
+    {
+        return std::unique_ptr<EnergyBackend>( new RaplBackend( requested_domains,
+                                                                get_option( "RAPL_SYSFS_ROOT", "/sys/class/powercap" ) ) );
+    }
+    if ( name == "sim" )
+    {
+        return std::unique_ptr<EnergyBackend>( new SimBackend( requested_domains, SimBackend::config_from_options() ) );
+    }
+    if ( name == "replay" )
+    {
+        return std::unique_ptr<EnergyBackend>( new ReplayBackend( requested_domains,
+                                                                  get_option( "REPLAY_FILE", "meric_recording.bin" ),
+                                                                  std::stod( get_option( "REPLAY_SPEED", "1" ) ) ) );
+    }
+    throw std::invalid_argument( "Unknown backend '" + name + "'. Expected one of " + join_strings( backend_names(), ", " ) );
+}
+
+
+std::vector<std::string>
+backend_names()
+{
+    return { "extlib", "rapl", "sim", "replay" };
+}
+}
+
+
+std::string
+MericPlugin::Domain::name() const
+{
+    return EnergyBackend::domain_name_by_id.at( id );
+}
+
+
+std::string
+MericPlugin::Domain::counter_names() const
+{
+    return join_strings( map_keys( counter_idx_by_name ), "," );
+}
@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include <meric_ext.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace MericPlugin
+{
+struct Domain
+{
+    unsigned int                                  id;  // The value in the Domains enum
+    unsigned int                                  idx; // The index in EnergyReading.domain_data
+
+    std::unordered_map<std::string, unsigned int> counter_idx_by_name;
+
+    std::string
+    name() const;
+
+    std::string
+    counter_names() const;
+};
+
+
+// Energy in J for all domains, laid out like ExtlibEnergyTimeStamp.domain_data
+struct EnergyReading
+{
+    struct DomainData
+    {
+        double              energy_total = 0.;
+        std::vector<double> energy_per_counter;
+    };
+
+    std::vector<DomainData> domain_data;
+    double                  energy_total = 0.; // TOTAL:TOTAL, for most backends the sum over all enabled domains
+};
+
+
+/*
+ * A source of energy readings.
+ *
+ * read() returns the energy accumulated since the backend was created, so that any two
+ * readings can be subtracted. Buffers passed to read() and calc_energy_consumption() are
+ * reused by the caller, implementations should only allocate when the layout changes.
+ */
+class EnergyBackend
+{
+public:
+    static const std::unordered_map<std::string, unsigned int> domain_id_by_name;
+    static const std::unordered_map<unsigned int, std::string> domain_name_by_id;
+
+    static std::vector<unsigned int>
+    all_domain_ids();
+
+    static std::vector<std::string>
+    all_domain_names();
+
+    virtual ~EnergyBackend() = default;
+
+    virtual std::unordered_map<std::string, Domain>
+    query_enabled_domains() = 0;
+
+    virtual void
+    read( EnergyReading& reading ) = 0;
+
+    // The energy consumed between two readings of this backend
+    virtual void
+    calc_energy_consumption( const EnergyReading& begin,
+                             const EnergyReading& end,
+                             EnergyReading&       result ) const;
+
+    // The longest time between two reads that cannot miss a wraparound of a counter,
+    // zero if the counters do not wrap or the limit is unknown
+    virtual std::chrono::microseconds
+    max_safe_interval() const
+    {
+        return std::chrono::microseconds( 0 );
+    }
+};
+
+
+// Create the backend with the given name ("extlib", "rapl", "sim" or "replay"), enabling the requested domains.
+// Throws std::invalid_argument for unknown backend names.
+std::unique_ptr<EnergyBackend>
+make_backend( const std::string&               name,
+              const std::vector<unsigned int>& requested_domains );
+
+std::vector<std::string>
+backend_names();
+}
@@ -6,6 +6,7 @@
  */
 
 #include "ExtlibWrapper.h"
+#include "RaplBackend.h"
 #include "utils.h"
 
 #include <scorep/plugin/log.hpp>
@@ -15,37 +16,13 @@ using scorep::plugin::logging;
 
 namespace MericPlugin
 {
-const std::unordered_map<std::string, unsigned int> ExtlibWrapper::domain_id_by_name = {
-    { "A64FX", ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_A64FX },
-    { "RAPL",  ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_RAPL  },
-    { "NVML",  ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_NVML  },
-    { "ROCM",  ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_ROCM  },
-    { "HDEEM", ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_HDEEM },
-    { "HWMON", ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_HWMON }
-};
-
-
-const std::unordered_map<unsigned int, std::string> ExtlibWrapper::domain_name_by_id =
-    map_inverse<std::string, unsigned int>( ExtlibWrapper::domain_id_by_name );
-
-
-std::vector<std::string> ExtlibWrapper::all_domain_names()
-{
-    return map_keys( ExtlibWrapper::domain_id_by_name );
-}
-
-
-std::vector<unsigned int> ExtlibWrapper::all_domain_ids()
-{
-    return map_keys( ExtlibWrapper::domain_name_by_id );
-}
-
-
-
 // We only need space for one measurement at a time, but a little bit
 // extra does not hurt.
 static constexpr unsigned int extlib_reserve_for_total_measurements = 3;
 
+// 2^32 counts of the default RAPL energy unit of 2^-16 J, at 500 W
+static const std::chrono::microseconds default_rapl_wrap_time = std::chrono::seconds( 65536 / 500 );
+
 
 ExtlibWrapper::ExtlibWrapper( const std::vector<unsigned int>& requested_domains ) :
     energy_domains( ExtlibEnergyPtr( new ExtlibEnergy( { 0 } ) ) )
@@ -65,6 +42,21 @@ ExtlibWrapper::ExtlibWrapper( const std::vector<unsigned int>& requested_domains
             logging::warn() << "Domain '" << ExtlibWrapper::domain_name_by_id.at( domain ) << "' was requested but could not be enabled";
         }
     }
+    if ( EXTLIB_ENERGY_HAS_DOMAIN( *energy_domains, ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_RAPL ) )
+    {
+        safe_interval = RaplBackend::max_safe_interval( "/sys/class/powercap" );
+        if ( safe_interval.count() == 0 )
+        {
+            safe_interval = default_rapl_wrap_time;
+        }
+    }
+}
+
+
+std::chrono::microseconds
+ExtlibWrapper::max_safe_interval() const
+{
+    return safe_interval;
 }
 
 
@@ -96,6 +88,53 @@ ExtlibWrapper::query_enabled_domains()
 }
 
 
+void
+ExtlibWrapper::read( EnergyReading& reading )
+{
+    TimeStamp current = this->read();
+    if ( previous )
+    {
+        TimeStamp delta = calc_energy_consumption( previous, current );
+        for ( unsigned int domain_idx = 0; domain_idx < EXTLIB_NUM_DOMAINS; ++domain_idx )
+        {
+            const auto& domain = delta->domain_data[ domain_idx ];
+            auto&       acc    = accumulated.domain_data[ domain_idx ];
+            acc.energy_per_counter.resize( domain.arr_size, 0. );
+            for ( unsigned int counter_idx = 0; counter_idx < domain.arr_size; ++counter_idx )
+            {
+                acc.energy_per_counter[ counter_idx ] += domain.energy_per_counter[ counter_idx ];
+            }
+            if ( EXTLIB_ENERGY_HAS_DOMAIN( *energy_domains, domain.domain_id ) )
+            {
+                acc.energy_total += domain.energy_total;
+            }
+        }
+        // TOTAL:TOTAL is the total extlib reports in its first domain entry, as before
+        // the backends were introduced, not a sum over the enabled domains
+        accumulated.energy_total += delta->domain_data[ 0 ].energy_total;
+    }
+    else
+    {
+        accumulated.domain_data.resize( EXTLIB_NUM_DOMAINS );
+        for ( unsigned int domain_idx = 0; domain_idx < EXTLIB_NUM_DOMAINS; ++domain_idx )
+        {
+            accumulated.domain_data[ domain_idx ].energy_per_counter.assign( current->domain_data[ domain_idx ].arr_size, 0. );
+        }
+    }
+    previous = std::move( current );
+
+    reading.domain_data.resize( EXTLIB_NUM_DOMAINS );
+    for ( unsigned int domain_idx = 0; domain_idx < EXTLIB_NUM_DOMAINS; ++domain_idx )
+    {
+        const auto& acc = accumulated.domain_data[ domain_idx ];
+        auto&       out = reading.domain_data[ domain_idx ];
+        out.energy_total = acc.energy_total;
+        out.energy_per_counter.assign( acc.energy_per_counter.begin(), acc.energy_per_counter.end() );
+    }
+    reading.energy_total = accumulated.energy_total;
+}
+
+
 ExtlibWrapper::TimeStamp
 ExtlibWrapper::read()
 {
@@ -115,18 +154,3 @@ ExtlibWrapper::calc_energy_consumption( TimeStamp begin, TimeStamp end )
                       /*deleter=*/ &extlib_free_energy_timestamp );
 }
 }
-
-
-std::string
-MericPlugin::ExtlibWrapper::Domain::name() const
-{
-    return ExtlibWrapper::domain_name_by_id.at( id );
-}
-
-
-
-std::string
-MericPlugin::ExtlibWrapper::Domain::counter_names() const
-{
-    return join_strings( map_keys( counter_idx_by_name ), "," );
-}
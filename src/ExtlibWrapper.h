@@ -6,10 +6,12 @@
  */
 #pragma once
 
+#include "EnergyBackend.h"
 #include "utils.h"
 
 #include <meric_ext.h>
 
+#include <chrono>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -19,38 +21,24 @@
 
 namespace MericPlugin
 {
-class ExtlibWrapper
+// Energy backend reading with MERIC extlib
+class ExtlibWrapper : public EnergyBackend
 {
 public:
+    using Domain = MericPlugin::Domain;
 
-    static const std::unordered_map<std::string, unsigned int> domain_id_by_name;
-    static const std::unordered_map<unsigned int, std::string> domain_name_by_id;
-
-    static std::vector<unsigned int>
-    all_domain_ids();
-
-    static std::vector<std::string>
-    all_domain_names();
-
-    ExtlibWrapper() = default;
     ExtlibWrapper( const std::vector<unsigned int>& requested_domains );
 
-    struct Domain
-    {
-        unsigned int                                  id;  // The value in the Domains enum
-        unsigned int                                  idx; // The index in an ExtlibEnergyTimeStamp.domain_data
-
-        std::unordered_map<std::string, unsigned int> counter_idx_by_name;
-
-        std::string
-        name() const;
+    std::unordered_map<std::string, Domain>
+    query_enabled_domains() override;
 
-        std::string
-        counter_names() const;
-    };
+    void
+    read( EnergyReading& reading ) override;
 
-    std::unordered_map<std::string, Domain>
-    query_enabled_domains();
+    // The 32-bit RAPL energy counters read by extlib wrap within minutes at high power.
+    // The bound of the powercap zones is used, or the default RAPL energy unit at 500 W.
+    std::chrono::microseconds
+    max_safe_interval() const override;
 
     using TimeStamp = std::shared_ptr<ExtlibEnergyTimeStamp>;
 
@@ -61,6 +49,7 @@ public:
     calc_energy_consumption( TimeStamp begin,
                              TimeStamp end );
 
+    using EnergyBackend::calc_energy_consumption;
 
 private:
     struct ExtlibDeleter
@@ -75,5 +64,12 @@ private:
     using ExtlibEnergyPtr = std::unique_ptr<ExtlibEnergy, ExtlibDeleter>;
 
     ExtlibEnergyPtr energy_domains;
+
+    // extlib only computes the consumption between two of its timestamps,
+    // so accumulate the consumption since the first read() here
+    TimeStamp     previous;
+    EnergyReading accumulated;
+
+    std::chrono::microseconds safe_interval{ 0 };
 };
 }
@@ -6,69 +6,667 @@
  *
  */
 #include "MeasurementThread.h"
+#include "utils.h"
 
+#include <scorep/plugin/log.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+
+
+using scorep::plugin::logging;
 
 namespace MericPlugin
 {
-MeasurementThread::MeasurementThread( std::chrono::microseconds interval ) : _interval( interval )
+MeasurementThread::MeasurementThread( std::chrono::microseconds interval, std::vector<BurstWindow> burst_schedule, TimestampSource timestamp_source ) :
+    active( false ),
+    _interval( interval ),
+    timestamp_source( timestamp_source ),
+    burst_schedule( std::move( burst_schedule ) )
 {
 }
 
 
 void
-MeasurementThread::start( ExtlibWrapper extlib, const std::vector<Metric>& handles )
+MeasurementThread::start( std::unique_ptr<EnergyBackend> backend, const std::vector<Metric>& handles )
 {
-    data.clear();
+    metric_columns.clear();
+    column_by_metric_id.clear();
     for ( auto& handle : handles )
     {
-        data.insert( std::make_pair( std::ref( const_cast<Metric&>( handle ) ),
-                                     std::vector<TVPair>() ) );
+        // Energy the daemon does not record would only be NaN, so such metrics get no values at all
+        if ( daemon && handle.isEnergy()
+             && std::find( daemon->metric_names().begin(), daemon->metric_names().end(), handle.name() ) == daemon->metric_names().end() )
+        {
+            logging::warn() << "The sampling daemon does not record " << handle.name() << ", the metric stays empty";
+            continue;
+        }
+        column_by_metric_id.emplace( handle.id(), metric_columns.size() );
+        metric_columns.push_back( &handle );
+    }
+    table.reset( metric_columns.size() );
+    metric_stats.assign( metric_columns.size(), MetricStats() );
+    metric_histograms.assign( histograms_enabled ? metric_columns.size() : 0, PowerHistogram() );
+    sampled_time       = 0.;
+    total_missed_ticks = 0;
+    num_samples_taken  = 0;
+    readings_by_column.clear();
+    clock_at_start = clock_pair();
+    this->backend = std::move( backend );
+    {
+        std::lock_guard<std::mutex> lock( control_mutex );
+        start_time   = Clock::now();
+        burst_active = false;
+        phase_locked = false;
     }
     active             = true;
     measurement_thread = std::thread([ this ](){
-            this->collect_readings();
+            if ( this->daemon )
+            {
+                this->copy_from_daemon();
+            }
+            else
+            {
+                this->collect_readings();
+            }
         } );
-    this->extlib = std::move( extlib );
 }
 
 
-ExtlibWrapper
+std::unique_ptr<EnergyBackend>
 MeasurementThread::stop()
 {
-    active = false;
+    {
+        std::lock_guard<std::mutex> lock( control_mutex );
+        active = false;
+    }
+    wakeup.notify_all();
     if ( measurement_thread.joinable() )
     {
         measurement_thread.join();
     }
-    return std::move( this->extlib );
+    clock_at_stop = clock_pair();
+    // Differences of the 64-bit clocks are taken in integers, before they are scaled
+    const double elapsed = double( std::int64_t( clock_at_stop.ticks.count() - clock_at_start.ticks.count() ) );
+    if ( daemon )
+    {
+        // The daemon stamps its samples with CLOCK_MONOTONIC, which the clock pairs map to ticks
+        const double elapsed_ns = double( std::int64_t( clock_at_stop.monotonic_ns - clock_at_start.monotonic_ns ) );
+        table.map_timestamps( clock_at_start.monotonic_ns, clock_at_start.ticks.count(), elapsed_ns > 0. ? elapsed / elapsed_ns : 1. );
+    }
+    else if ( raw_stamps )
+    {
+        const double elapsed_raw = double( std::int64_t( clock_at_stop.raw - clock_at_start.raw ) );
+        table.map_timestamps( clock_at_start.raw, clock_at_start.ticks.count(), elapsed_raw > 0. ? elapsed / elapsed_raw : 1. );
+    }
+    if ( resample_step.count() > 0 )
+    {
+        resample();
+    }
+    readings_by_column = table.materialize( std::thread::hardware_concurrency() );
+    return std::move( this->backend );
 }
 
 
-std::vector<MeasurementThread::TVPair>&
-MeasurementThread::readings( Metric& handle )
+// Replaces the samples by their resampling onto the grid of resample_step
+void
+MeasurementThread::resample()
 {
-    return data[ handle ];
+    // The clock pairs give the rate of the ticks, and place the grid on realtime multiples
+    const double elapsed_ns = double( clock_at_stop.realtime_ns ) - double( clock_at_start.realtime_ns );
+    const double elapsed    = double( clock_at_stop.ticks.count() ) - double( clock_at_start.ticks.count() );
+    if ( elapsed_ns <= 0. || elapsed <= 0. )
+    {
+        logging::warn() << "Cannot resample, the measurement was too short";
+        return;
+    }
+    const double        ticks_per_ns = elapsed / elapsed_ns;
+    const std::uint64_t step_ns      = std::chrono::duration_cast<std::chrono::nanoseconds>( resample_step ).count();
+    const double        origin       = clock_at_start.ticks.count() - double( clock_at_start.realtime_ns % step_ns ) * ticks_per_ns;
+
+    std::vector<std::size_t> held_metrics;
+    for ( std::size_t column = 0; column < metric_columns.size(); ++column )
+    {
+        if ( !metric_columns[ column ]->isEnergy() )
+        {
+            held_metrics.push_back( column );
+        }
+    }
+    const auto raw_samples = table.size();
+    table = table.resample( origin, step_ns * ticks_per_ns, held_metrics );
+    logging::info() << "Resampled " << raw_samples << " samples to " << table.size() << " samples every "
+                    << resample_step.count() << " us";
+}
+
+
+void
+MeasurementThread::publish_to( std::unique_ptr<TelemetryRingWriter> ring )
+{
+    telemetry = std::move( ring );
+}
+
+
+const std::vector<MeasurementThread::TVPair>&
+MeasurementThread::readings( Metric& handle ) const
+{
+    static const std::vector<TVPair> no_readings;
+    const auto                       it = column_by_metric_id.find( handle.id() );
+    if ( it == column_by_metric_id.end() || it->second >= readings_by_column.size() )
+    {
+        return no_readings;
+    }
+    return readings_by_column[ it->second ];
+}
+
+
+MeasurementThread::ClockPair
+MeasurementThread::clock_pair() const
+{
+    // The raw time is the midpoint of two reads around the timestamp source. Of a few tries,
+    // the one with the closest reads is kept, as it was the least likely to be interrupted.
+    scorep::chrono::ticks ticks;
+    std::uint64_t         raw     = 0;
+    std::uint64_t         closest = UINT64_MAX;
+    for ( int i = 0; i < 5; ++i )
+    {
+        const auto raw_before = RawClock::now();
+        const auto try_ticks  = timestamp_source();
+        const auto raw_after  = RawClock::now();
+        if ( raw_after - raw_before < closest )
+        {
+            closest = raw_after - raw_before;
+            ticks   = try_ticks;
+            raw     = raw_before + ( raw_after - raw_before ) / 2;
+        }
+    }
+    struct timespec ts;
+    clock_gettime( CLOCK_REALTIME, &ts );
+    return { ticks, raw, std::uint64_t( ts.tv_sec ) * 1000000000ULL + ts.tv_nsec, TelemetryRing::monotonic_ns() };
+}
+
+
+bool
+MeasurementThread::begin_burst( std::chrono::microseconds interval, std::chrono::microseconds duration )
+{
+    {
+        std::lock_guard<std::mutex> lock( control_mutex );
+        // Bounded like set_interval(), and by max_duration, so that the deadlines do not overflow
+        std::chrono::microseconds longest = max_duration;
+        if ( max_interval.count() > 0 )
+        {
+            longest = std::min( longest, max_interval );
+        }
+        if ( interval.count() <= 0 || interval > longest )
+        {
+            logging::warn() << "Rejecting the burst interval of " << interval.count() << " us, expected 1 to "
+                            << longest.count() << " us";
+            return false;
+        }
+        burst_active    = true;
+        burst_interval  = interval;
+        // Clamped, so that the end of the burst does not overflow
+        burst_until     = duration.count() > 0 ? Clock::now() + std::min<std::chrono::microseconds>( duration, max_duration )
+                                               : Clock::time_point::max();
+        control_changed = true;
+        pending_reconfigurations++;
+    }
+    wakeup.notify_all();
+    return true;
+}
+
+
+void
+MeasurementThread::end_burst()
+{
+    {
+        std::lock_guard<std::mutex> lock( control_mutex );
+        burst_active    = false;
+        control_changed = true;
+        pending_reconfigurations++;
+    }
+    wakeup.notify_all();
+}
+
+
+bool
+MeasurementThread::set_interval( std::chrono::microseconds interval )
+{
+    {
+        std::lock_guard<std::mutex> lock( control_mutex );
+        if ( max_interval.count() > 0 && interval > max_interval )
+        {
+            logging::warn() << "Rejecting the interval of " << interval.count() << " us, counters could wrap unnoticed above "
+                            << max_interval.count() << " us";
+            return false;
+        }
+        _interval = interval;
+        if ( phase_locked )
+        {
+            // Stay a multiple of the counter update period, see calibrate()
+            _interval = std::max<std::chrono::microseconds::rep>( 1, ( interval + update_period - std::chrono::microseconds( 1 ) ) / update_period ) * update_period;
+            if ( max_interval.count() > 0 && _interval > max_interval && _interval > update_period )
+            {
+                _interval -= update_period;
+            }
+        }
+        control_changed = true;
+        pending_reconfigurations++;
+    }
+    wakeup.notify_all();
+    return true;
+}
+
+
+void
+MeasurementThread::mask_domains( std::vector<bool> disabled )
+{
+    std::lock_guard<std::mutex> lock( control_mutex );
+    disabled_domains = std::move( disabled );
+    pending_reconfigurations++;
+}
+
+
+// Whether the metric belongs to a domain masked with mask_domains()
+static bool
+is_masked( const Metric& metric, const std::vector<bool>& disabled )
+{
+    return ( metric.isSingle() || metric.isDomainTotal() ) && metric.domain_idx < disabled.size() && disabled[ metric.domain_idx ];
+}
+
+
+// Requires control_mutex to be held
+std::chrono::microseconds
+MeasurementThread::current_interval( Clock::time_point now ) const
+{
+    if ( burst_active && now < burst_until )
+    {
+        return burst_interval;
+    }
+    const auto elapsed = now - start_time;
+    for ( const auto& window : burst_schedule )
+    {
+        if ( elapsed >= window.begin && elapsed < window.begin + window.duration )
+        {
+            return window.interval;
+        }
+    }
+    return _interval;
+}
+
+
+// Requires control_mutex to be held.
+// Returns the earliest point after `now` at which current_interval() may change.
+MeasurementThread::Clock::time_point
+MeasurementThread::next_interval_change( Clock::time_point now ) const
+{
+    Clock::time_point next = Clock::time_point::max();
+    if ( burst_active && now < burst_until )
+    {
+        next = burst_until;
+    }
+    for ( const auto& window : burst_schedule )
+    {
+        for ( const auto edge : { start_time + window.begin, start_time + window.begin + window.duration } )
+        {
+            if ( edge > now )
+            {
+                next = std::min( next, edge );
+            }
+        }
+    }
+    return next;
+}
+
+
+// Requires control_mutex to be held
+MeasurementThread::Clock::time_point
+MeasurementThread::next_deadline( Clock::time_point last_sample, std::chrono::microseconds interval ) const
+{
+    if ( ( !phase_locked && !align_to_realtime ) || interval.count() <= 0 )
+    {
+        return last_sample + interval;
+    }
+    const auto step   = std::chrono::duration_cast<Clock::duration>( interval );
+    auto       origin = phase_origin;
+    if ( align_to_realtime )
+    {
+        // The steady time of the last realtime multiple of the interval. Taken anew for
+        // every deadline, so that adjustments of the realtime clock are followed.
+        struct timespec ts;
+        clock_gettime( CLOCK_REALTIME, &ts );
+        const auto now         = Clock::now();
+        const auto realtime_ns = std::uint64_t( ts.tv_sec ) * 1000000000ULL + ts.tv_nsec;
+        const auto step_ns     = std::uint64_t( std::chrono::duration_cast<std::chrono::nanoseconds>( interval ).count() );
+        origin = now - std::chrono::duration_cast<Clock::duration>( std::chrono::nanoseconds( realtime_ns % step_ns ) );
+    }
+
+    // The first grid point after last_sample
+    const auto since = std::chrono::duration_cast<Clock::duration>( last_sample - origin );
+    auto       ticks = since / step;
+    if ( since < Clock::duration::zero() && since % step != Clock::duration::zero() )
+    {
+        --ticks;
+    }
+    return origin + ( ticks + 1 ) * step;
+}
+
+
+// Reads the backend for calibration_duration, to find the update period of the sampled
+// domains, and adapts the interval to it. `reading` is the latest reading afterwards.
+void
+MeasurementThread::calibrate( const EnergyReading& baseline )
+{
+    // Domains of the metrics, TOTAL samples all domains
+    std::vector<bool> sampled( baseline.domain_data.size(), false );
+    for ( const Metric* metric : metric_columns )
+    {
+        if ( metric->isTotal() )
+        {
+            std::fill( sampled.begin(), sampled.end(), true );
+        }
+        else if ( ( metric->isSingle() || metric->isDomainTotal() ) && metric->domain_idx < sampled.size() )
+        {
+            sampled[ metric->domain_idx ] = true;
+        }
+    }
+
+    // The baseline stays the start of the first sample, updates are detected on a copy
+    std::vector<std::vector<Clock::time_point> > updates( sampled.size() );
+    EnergyReading                                last = baseline;
+    EnergyReading                                cur;
+    const auto                                   end = Clock::now() + calibration_duration;
+    while ( active && Clock::now() < end )
+    {
+        std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+        this->backend->read( cur );
+        const auto now = Clock::now();
+        for ( std::size_t idx = 0; idx < sampled.size() && idx < cur.domain_data.size(); ++idx )
+        {
+            if ( sampled[ idx ] && cur.domain_data[ idx ].energy_total != last.domain_data[ idx ].energy_total )
+            {
+                updates[ idx ].push_back( now );
+            }
+        }
+        std::swap( last, cur );
+    }
+
+    // The median update period of the slowest sampled domain
+    Clock::duration   refresh = Clock::duration::zero();
+    Clock::time_point last_update;
+    for ( std::size_t idx = 0; idx < updates.size(); ++idx )
+    {
+        if ( updates[ idx ].size() < 3 )
+        {
+            // Domains that do not change are not sampled, or not used by the application
+            continue;
+        }
+        std::vector<Clock::duration> periods;
+        for ( std::size_t i = 1; i < updates[ idx ].size(); ++i )
+        {
+            periods.push_back( updates[ idx ][ i ] - updates[ idx ][ i - 1 ] );
+        }
+        std::nth_element( periods.begin(), periods.begin() + periods.size() / 2, periods.end() );
+        if ( periods[ periods.size() / 2 ] > refresh )
+        {
+            refresh     = periods[ periods.size() / 2 ];
+            last_update = updates[ idx ].back();
+        }
+    }
+    if ( refresh == Clock::duration::zero() )
+    {
+        logging::warn() << "Could not detect the counter update period during the calibration of "
+                        << calibration_duration.count() << " us, keeping the interval";
+        return;
+    }
+
+    const auto refresh_us = std::chrono::duration_cast<std::chrono::microseconds>( refresh ) + std::chrono::microseconds( 1 );
+    std::lock_guard<std::mutex> lock( control_mutex );
+    const auto                  requested = _interval;
+    if ( auto_interval_mode == AutoInterval::align )
+    {
+        // A multiple of the update period, sampling shortly after the updates
+        const auto multiple = std::max<std::chrono::microseconds::rep>( 1, ( _interval + refresh_us - std::chrono::microseconds( 1 ) ) / refresh_us );
+        _interval     = multiple * refresh_us;
+        update_period = refresh_us;
+        phase_locked  = true;
+        phase_origin  = last_update + refresh / 20;
+    }
+    else
+    {
+        _interval = std::max( _interval, refresh_us );
+    }
+    if ( max_interval.count() > 0 && _interval > max_interval )
+    {
+        logging::warn() << "Limiting the interval to " << max_interval.count() << " us, counters could wrap unnoticed above";
+        _interval = max_interval;
+    }
+    logging::info() << "Counters update every " << refresh_us.count() << " us, sampling interval "
+                    << requested.count() << " us -> " << _interval.count() << " us";
 }
 
 
 void
 MeasurementThread::collect_readings()
 {
-    ExtlibWrapper::TimeStamp prev, cur;
-    prev = this->extlib.read();
+    // The buffers are reused, so that the loop does not allocate once their layout is known
+    EnergyReading prev, cur, res;
+    SamplerHealth    health;
+    EfficiencySample efficiency;
+    this->backend->read( prev );
+    // The first sample covers the calibration, so that no energy is missing
+    Clock::time_point prev_sample = Clock::now();
+    if ( cpu_accounting )
+    {
+        cpu_accounting->share(); // Start the attribution at the first reading
+    }
+    if ( efficiency_counters )
+    {
+        efficiency_counters->read( efficiency, 0., 0. );
+    }
+    if ( auto_interval_mode != AutoInterval::off )
+    {
+        calibrate( prev );
+    }
+    Clock::time_point         last_sample = Clock::now();
+    Clock::time_point         scheduled   = last_sample;
+    std::chrono::microseconds scheduled_interval( 0 );
+    std::vector<double>       values( metric_columns.size() );
+    std::vector<bool>         disabled;
     while ( active )
     {
-        const auto timestamp = scorep::chrono::measurement_clock::now();
-        cur = this->extlib.read();
-        ExtlibWrapper::TimeStamp res = ExtlibWrapper::calc_energy_consumption( prev, cur );
-        for ( auto& item : data )
+        // Only the read is between the stamps. Raw stamps are mapped to ticks in stop().
+        last_sample = Clock::now();
+        const auto read_begin = raw_stamps ? scorep::chrono::ticks( RawClock::now() ) : timestamp_source();
+        this->backend->read( cur );
+        const auto read_end  = raw_stamps ? scorep::chrono::ticks( RawClock::now() ) : timestamp_source();
+        const auto read_done = Clock::now();
+        const double cpu_share = cpu_accounting ? cpu_accounting->share() : 1.;
+        scorep::chrono::ticks timestamp;
+        switch ( stamp_position )
+        {
+            case StampAt::begin:
+                timestamp = read_begin;
+                break;
+            case StampAt::midpoint:
+                timestamp = scorep::chrono::ticks( read_begin.count() + ( read_end.count() - read_begin.count() ) / 2 );
+                break;
+            case StampAt::end:
+                timestamp = read_end;
+                break;
+        }
+        this->backend->calc_energy_consumption( prev, cur, res );
+        const double duration = std::chrono::duration<double>( last_sample - prev_sample ).count();
+        if ( efficiency_counters )
+        {
+            efficiency_counters->read( efficiency, duration,
+                                       efficiency_domain < res.domain_data.size() ? res.domain_data[ efficiency_domain ].energy_total : res.energy_total );
+        }
+
+        const auto lateness = std::max( last_sample - scheduled, Clock::duration::zero() );
+        health.values[ SamplerHealth::read_latency ]    = std::chrono::duration<double>( read_done - last_sample ).count();
+        health.values[ SamplerHealth::sample_lateness ] = std::chrono::duration<double>( lateness ).count();
+        health.values[ SamplerHealth::missed_ticks ]    = scheduled_interval.count() > 0 ? lateness / scheduled_interval : 0;
+        health.values[ SamplerHealth::buffer_bytes ]    = table.bytes();
+        for ( std::size_t i = 0; i < metric_columns.size(); ++i )
         {
-            const auto& metric   = item.first.get();
-            auto&       sequence = item.second;
-            sequence.emplace_back( timestamp, metric.read( res.get() ) );
+            values[ i ] = metric_columns[ i ]->read( res, health, efficiency );
+            if ( metric_columns[ i ]->self )
+            {
+                values[ i ] *= cpu_share;
+            }
+            if ( is_masked( *metric_columns[ i ], disabled ) )
+            {
+                values[ i ] = NAN;
+            }
         }
-        prev = cur;
-        std::this_thread::sleep_for( _interval );
+        record_sample( timestamp, values.data(), duration, health.values[ SamplerHealth::missed_ticks ] );
+        if ( telemetry )
+        {
+            telemetry->publish( std::chrono::duration_cast<std::chrono::nanoseconds>( last_sample.time_since_epoch() ).count(),
+                                std::chrono::duration_cast<std::chrono::nanoseconds>( last_sample - prev_sample ).count(),
+                                values.data() );
+        }
+        std::swap( prev, cur );
+        prev_sample = last_sample;
+
+        // Sleep until the next deadline. Burst requests wake us up early, so that
+        // a switch to a shorter interval takes effect immediately.
+        std::unique_lock<std::mutex> lock( control_mutex );
+        control_changed = false;
+        while ( active )
+        {
+            const auto now = Clock::now();
+            scheduled_interval = current_interval( now );
+            scheduled          = std::min( next_deadline( last_sample, scheduled_interval ), next_interval_change( now ) );
+            if ( now >= scheduled )
+            {
+                break;
+            }
+            wakeup.wait_until( lock, scheduled, [ this ](){
+                    return !active || control_changed;
+                } );
+            control_changed = false;
+        }
+        health.values[ SamplerHealth::reconfigured ] = pending_reconfigurations;
+        pending_reconfigurations                     = 0;
+        disabled                                     = disabled_domains;
+    }
+}
+
+
+void
+MeasurementThread::record_sample( scorep::chrono::ticks timestamp, const double* values, double duration, double missed )
+{
+    if ( samples_enabled )
+    {
+        table.append( timestamp, values );
+    }
+
+    sampled_time       += duration;
+    total_missed_ticks += missed;
+    num_samples_taken++;
+    for ( std::size_t i = 0; i < metric_columns.size(); ++i )
+    {
+        if ( metric_columns[ i ]->isEnergy() && std::isfinite( values[ i ] ) )
+        {
+            metric_stats[ i ].energy += values[ i ];
+            if ( duration > 0. )
+            {
+                const double power = values[ i ] / duration;
+                metric_stats[ i ].min_power  = std::min( metric_stats[ i ].min_power, power );
+                metric_stats[ i ].peak_power = std::max( metric_stats[ i ].peak_power, power );
+                if ( histograms_enabled )
+                {
+                    metric_histograms[ i ].add( power, duration );
+                }
+            }
+        }
+    }
+}
+
+
+// Copies the samples the daemon took since start() into the table, with their
+// CLOCK_MONOTONIC timestamps. Slots overwritten before they were copied count as missed.
+void
+MeasurementThread::copy_from_daemon()
+{
+    std::vector<int> ring_column( metric_columns.size(), -1 );
+    const auto&      ring_names = daemon->metric_names();
+    for ( std::size_t i = 0; i < metric_columns.size(); ++i )
+    {
+        const auto it = std::find( ring_names.begin(), ring_names.end(), metric_columns[ i ]->name() );
+        if ( it != ring_names.end() )
+        {
+            ring_column[ i ] = it - ring_names.begin();
+        }
+    }
+
+    const EnergyReading   no_reading;
+    SamplerHealth         health;
+    EfficiencySample      efficiency;
+    TelemetryRing::Sample sample;
+    std::vector<double>   values( metric_columns.size() );
+    std::vector<bool>     disabled;
+    std::fill( health.values, health.values + SamplerHealth::num_values, NAN );
+    std::fill( efficiency.values, efficiency.values + EfficiencySample::num_values, NAN );
+
+    const std::uint64_t begin_ns = clock_at_start.monotonic_ns;
+    const auto          period   = std::chrono::microseconds( std::max<std::uint64_t>( 1, daemon->num_slots() * daemon->interval_us() / 4 ) );
+    std::uint64_t       next     = daemon->write_index();
+    while ( true )
+    {
+        const bool          last   = !active;
+        const std::uint64_t end_ns = last ? TelemetryRing::monotonic_ns() : UINT64_MAX;
+        const std::uint64_t end    = daemon->write_index();
+        std::uint64_t       missed = 0;
+        for ( ; next < end; ++next )
+        {
+            if ( !daemon->read( next, sample ) )
+            {
+                ++missed;
+                continue;
+            }
+            if ( sample.timestamp_ns < begin_ns )
+            {
+                continue;
+            }
+            if ( sample.timestamp_ns > end_ns )
+            {
+                break;
+            }
+            health.values[ SamplerHealth::missed_ticks ] = missed;
+            health.values[ SamplerHealth::buffer_bytes ] = table.bytes();
+            for ( std::size_t i = 0; i < metric_columns.size(); ++i )
+            {
+                if ( ring_column[ i ] >= 0 && !is_masked( *metric_columns[ i ], disabled ) )
+                {
+                    values[ i ] = sample.values[ ring_column[ i ] ];
+                }
+                else
+                {
+                    values[ i ] = metric_columns[ i ]->isEnergy() ? NAN : metric_columns[ i ]->read( no_reading, health, efficiency );
+                }
+            }
+            health.values[ SamplerHealth::reconfigured ] = 0;
+            record_sample( scorep::chrono::ticks( sample.timestamp_ns ), values.data(), sample.duration_ns * 1e-9, missed );
+            missed = 0;
+        }
+        total_missed_ticks += missed;
+        if ( last )
+        {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock( control_mutex );
+        wakeup.wait_for( lock, period, [ this ](){
+                return !active;
+            } );
+        // The samples of the daemon are only copied now, the changes apply to the next copy
+        health.values[ SamplerHealth::reconfigured ] = pending_reconfigurations;
+        pending_reconfigurations                     = 0;
+        disabled                                     = disabled_domains;
     }
 }
 }
@@ -8,11 +8,23 @@
 #pragma once
 
 #include "Metric.h"
-#include "ExtlibWrapper.h"
+#include "CpuAccounting.h"
+#include "EfficiencyCounters.h"
+#include "EnergyBackend.h"
+#include "PowerHistogram.h"
+#include "RawClock.h"
+#include "SampleTable.h"
+#include "TelemetryRing.h"
 
 #include <scorep/chrono/chrono.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -22,23 +34,260 @@ namespace MericPlugin
 {
 class MeasurementThread
 {
-    using TVPair = std::pair<scorep::chrono::ticks, double>;
+    using TVPair = SampleTable::TVPair;
+    using Clock  = std::chrono::steady_clock;
 public:
-    MeasurementThread( std::chrono::microseconds interval );
+    // A Score-P timestamp, the RawClock time at the same moment, and the CLOCK_REALTIME and
+    // CLOCK_MONOTONIC times taken right after it
+    struct ClockPair
+    {
+        scorep::chrono::ticks ticks;
+        std::uint64_t         raw;
+        std::uint64_t         realtime_ns;
+        std::uint64_t         monotonic_ns;
+    };
+
+    // A window with a shorter sampling interval, relative to the start of the measurement
+    struct BurstWindow
+    {
+        std::chrono::microseconds begin;
+        std::chrono::microseconds interval;
+        std::chrono::microseconds duration;
+    };
+
+    // Running statistics of one energy metric, updated with every sample
+    struct MetricStats
+    {
+        double energy     = 0.;        // J
+        double min_power  = INFINITY;  // W
+        double peak_power = -INFINITY; // W
+    };
+
+    // Source of the sample timestamps. Outside of a Score-P measurement, e.g. in tests,
+    // the Score-P clock is not available and another source has to be used.
+    using TimestampSource = scorep::chrono::ticks ( * )();
+
+    // Point of the backend read a sample is stamped with. Reads of slow sensors can take
+    // milliseconds, the midpoint avoids a skew of half the read time.
+    enum class StampAt
+    {
+        begin,
+        midpoint,
+        end
+    };
+
+    // Adapt the interval to the update period of the sampled counters, measured during a
+    // short calibration when the sampling starts.
+    // clamp: never sample faster than the slowest sampled domain updates.
+    // align: use a multiple of that update period, and sample just after the updates.
+    enum class AutoInterval
+    {
+        off,
+        clamp,
+        align
+    };
+
+    MeasurementThread( std::chrono::microseconds interval,
+                       std::vector<BurstWindow>  burst_schedule = {},
+                       TimestampSource           timestamp_source = &scorep::chrono::measurement_clock::now );
 
     void
-    start( ExtlibWrapper              extlib,
-           const std::vector<Metric>& handles );
+    start( std::unique_ptr<EnergyBackend> backend,
+           const std::vector<Metric>&     handles );
 
-    ExtlibWrapper
+    // Stop sampling and hand the backend back to the caller
+    std::unique_ptr<EnergyBackend>
     stop();
 
-    std::vector<TVPair>&
-    readings( Metric& handle );
+    // Must be called before start()
+    void
+    stamp_at( StampAt position )
+    {
+        stamp_position = position;
+    }
+
+    // Stamp the samples with RawClock instead of the timestamp source, and map them to
+    // ticks with the clock pairs of start and stop. Must be called before start().
+    void
+    stamp_with_raw_clock( bool enable )
+    {
+        raw_stamps = enable;
+    }
+
+    // Must be called before start()
+    void
+    auto_interval( AutoInterval              mode,
+                   std::chrono::microseconds calibration )
+    {
+        auto_interval_mode   = mode;
+        calibration_duration = calibration;
+    }
+
+    // Put the deadlines on multiples of the interval in CLOCK_REALTIME, so that the samples
+    // of all hosts with synchronized clocks fall on a common grid. Must be called before start().
+    void
+    align_phase_to_realtime( bool align )
+    {
+        align_to_realtime = align;
+    }
+
+    // Resample all energy metrics at stop() onto a uniform grid with spacing `step`,
+    // on multiples of `step` in CLOCK_REALTIME. Zero keeps the raw samples.
+    void
+    resample_to( std::chrono::microseconds step )
+    {
+        resample_step = step;
+    }
+
+    // Keep a power histogram per energy metric. Without `store_samples`, only the
+    // statistics and histograms are kept, and no samples. Must be called before start().
+    void
+    keep_histograms( bool keep,
+                     bool store_samples = true )
+    {
+        histograms_enabled = keep;
+        samples_enabled    = store_samples;
+    }
+
+    // Scale the <domain>:<counter>:SELF metrics by the share of the CPU time of the traced
+    // processes, read right after the energy counters. Must be called before start().
+    void
+    attribute_cpu_energy( std::unique_ptr<CpuAccounting> accounting )
+    {
+        cpu_accounting = std::move( accounting );
+    }
+
+    // Read the EFF metrics in every iteration of the sampler. J_per_Ginstr uses the energy of
+    // the domain at `energy_domain_idx` in EnergyReading.domain_data, or the total energy if
+    // it is out of range. Must be called before start().
+    void
+    co_sample_efficiency( std::unique_ptr<EfficiencyCounters> counters,
+                          unsigned int                        energy_domain_idx )
+    {
+        efficiency_counters = std::move( counters );
+        efficiency_domain   = energy_domain_idx;
+    }
+
+    // Copy the samples of a meric_sampld daemon from its ring instead of reading a backend.
+    // Energy metrics are matched to the ring by name, missing ones are NaN. The samples are
+    // copied every quarter of the ring, and their CLOCK_MONOTONIC timestamps are converted
+    // to ticks at stop(). Must be called before start(), which then takes no backend.
+    void
+    attach_to( std::unique_ptr<TelemetryRingReader> ring )
+    {
+        daemon = std::move( ring );
+    }
+
+    // Publish every sample to a shared-memory ring. The ring must describe the
+    // metrics in the order of the handles passed to start().
+    void
+    publish_to( std::unique_ptr<TelemetryRingWriter> ring );
+
+    // The samples of one metric, prepared in parallel by stop()
+    const std::vector<TVPair>&
+    readings( Metric& handle ) const;
+
+    // All samples, with one column per handle in the order passed to start()
+    const SampleTable&
+    samples() const
+    {
+        return table;
+    }
+
+    // Free the samples after stop(), once only readings() are needed
+    void
+    release_samples()
+    {
+        table = SampleTable();
+    }
+
+    const std::vector<const Metric*>&
+    metrics() const
+    {
+        return metric_columns;
+    }
+
+    // Statistics per metric, in the order of metrics().
+    // Only energy metrics have statistics.
+    const std::vector<MetricStats>&
+    stats() const
+    {
+        return metric_stats;
+    }
+
+    // Power histograms per metric, in the order of the handles passed to start(),
+    // if enabled with keep_histograms(). Other than energy metrics have empty histograms.
+    const std::vector<PowerHistogram>&
+    histograms() const
+    {
+        return metric_histograms;
+    }
+
+    // Time covered by the samples, in s
+    double
+    sampled_seconds() const
+    {
+        return sampled_time;
+    }
+
+    std::uint64_t
+    missed_ticks() const
+    {
+        return total_missed_ticks;
+    }
+
+    // Number of samples taken, also when they are not stored or were resampled
+    std::uint64_t
+    samples_taken() const
+    {
+        return num_samples_taken;
+    }
+
+    // Clock pairs taken at start() and stop()
+    const ClockPair&
+    start_clock() const
+    {
+        return clock_at_start;
+    }
+
+    const ClockPair&
+    stop_clock() const
+    {
+        return clock_at_stop;
+    }
+
+    // Sample with `interval` for `duration`, or until end_burst() if duration is zero.
+    // Returns false, with a warning, if the interval is zero or above the limit_interval() bound.
+    bool
+    begin_burst( std::chrono::microseconds interval,
+                 std::chrono::microseconds duration );
+
+    void
+    end_burst();
+
+    // Change the regular sampling interval while sampling. Returns false, with a warning,
+    // if the interval is above the limit_interval() bound.
+    bool
+    set_interval( std::chrono::microseconds interval );
+
+    // Longest interval that set_interval() and the automatic interval may choose, e.g. the
+    // longest interval that does not miss counter wraparounds. Zero for no limit.
+    void
+    limit_interval( std::chrono::microseconds max )
+    {
+        std::lock_guard<std::mutex> lock( control_mutex );
+        max_interval = max;
+    }
+
+    // Record the energy metrics of the domains with disabled[ domain_idx ] as NaN. TOTAL
+    // metrics are not affected. An empty vector records all domains.
+    void
+    mask_domains( std::vector<bool> disabled );
 
     inline const std::chrono::microseconds
     interval() const
     {
+        std::lock_guard<std::mutex> lock( control_mutex );
         return _interval;
     };
 
@@ -46,14 +295,82 @@ private:
     void
     collect_readings();
 
-    std::unordered_map<std::reference_wrapper<Metric>,
-                       std::vector<TVPair>,
-                       std::hash<Metric>,
-                       std::equal_to<Metric> > data;
+    void
+    copy_from_daemon();
+
+    // Stores one sample and updates the statistics, `values` has one entry per metric
+    void
+    record_sample( scorep::chrono::ticks timestamp,
+                   const double*         values,
+                   double                duration,
+                   double                missed );
+
+    std::chrono::microseconds
+    current_interval( Clock::time_point now ) const;
+
+    Clock::time_point
+    next_interval_change( Clock::time_point now ) const;
+
+    Clock::time_point
+    next_deadline( Clock::time_point         last_sample,
+                   std::chrono::microseconds interval ) const;
+
+    void
+    calibrate( const EnergyReading& baseline );
+
+    void
+    resample();
+
+    ClockPair
+    clock_pair() const;
+
+    SampleTable                                  table;
+    std::vector<std::vector<TVPair> >            readings_by_column;
+    std::vector<const Metric*>                   metric_columns;
+    std::unordered_map<std::size_t, std::size_t> column_by_metric_id;
+    std::vector<MetricStats>                     metric_stats;
+    std::vector<PowerHistogram>                  metric_histograms;
+    double                                       sampled_time       = 0.;
+    std::uint64_t                                total_missed_ticks = 0;
+    std::uint64_t                                num_samples_taken  = 0;
+    ClockPair                                    clock_at_start;
+    ClockPair                                    clock_at_stop;
+
+    std::unique_ptr<TelemetryRingWriter> telemetry;
+    std::unique_ptr<TelemetryRingReader> daemon;
+    std::unique_ptr<CpuAccounting>       cpu_accounting;
+    std::unique_ptr<EfficiencyCounters>  efficiency_counters;
+    unsigned int                         efficiency_domain = 0;
+
+    std::thread                    measurement_thread;
+    std::atomic<bool>              active;
+    std::chrono::microseconds      _interval;
+    std::unique_ptr<EnergyBackend> backend;
+    TimestampSource                timestamp_source;
+    StampAt                        stamp_position = StampAt::midpoint;
+    bool                           raw_stamps     = false;
+    AutoInterval                   auto_interval_mode = AutoInterval::off;
+    std::chrono::microseconds      calibration_duration;
+    bool                           align_to_realtime = false;
+    std::chrono::microseconds      resample_step = std::chrono::microseconds( 0 );
+    bool                           histograms_enabled = false;
+    bool                           samples_enabled    = true;
 
-    std::thread               measurement_thread;
-    bool                      active;
-    std::chrono::microseconds _interval;
-    ExtlibWrapper             extlib;
+    // Burst state, guarded by control_mutex. Changes wake up the measurement thread.
+    std::vector<BurstWindow>  burst_schedule;
+    Clock::time_point         start_time;
+    bool                      burst_active = false;
+    std::chrono::microseconds burst_interval;
+    Clock::time_point         burst_until;
+    bool                      control_changed = false;
+    std::uint64_t             pending_reconfigurations = 0; // Since the previous sample
+    std::vector<bool>         disabled_domains;
+    // With a locked phase, deadlines are on a grid of the interval starting at phase_origin
+    bool                      phase_locked = false;
+    Clock::time_point         phase_origin;
+    std::chrono::microseconds update_period{ 0 }; // Of the counters, if calibrated
+    std::chrono::microseconds max_interval{ 0 };
+    mutable std::mutex        control_mutex;
+    std::condition_variable   wakeup;
 };
 }
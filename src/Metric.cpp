@@ -8,30 +8,61 @@
 #include "Metric.h"
 
 #include <chrono>
+#include <cmath>
 #include <string>
 #include <sstream>
 
 
 namespace MericPlugin
 {
-Metric::Metric( Metric::Single, unsigned int domain_idx, unsigned int domain_id, std::string domain_name, unsigned int counter_idx, std::string counter_name ) :
+const char* const SamplerHealth::names[ num_values ] = {
+    "read_latency", "sample_lateness", "missed_ticks", "buffer_bytes", "reconfigured"
+};
+const char* const SamplerHealth::units[ num_values ] = {
+    "s", "s", "#", "B", "#"
+};
+const char* const SamplerHealth::descriptions[ num_values ] = {
+    "Duration of the energy backend read",
+    "Delay of the sample behind its scheduled time",
+    "Number of sampling intervals skipped before the sample",
+    "Memory allocated by the plugin for the recorded samples",
+    "Number of changes of the interval, domains or bursts since the previous sample"
+};
+
+const char* const EfficiencySample::names[ num_values ] = {
+    "avg_MHz", "Ginstr_per_s", "IPC", "J_per_Ginstr"
+};
+const char* const EfficiencySample::units[ num_values ] = {
+    "MHz", "Ginstr/s", "#", "J/Ginstr"
+};
+const char* const EfficiencySample::descriptions[ num_values ] = {
+    "Average frequency of all CPUs in the interval",
+    "Instructions retired by all CPUs",
+    "Instructions per cycle of all CPUs",
+    "Energy of the CPU domain per billion instructions retired"
+};
+
+
+Metric::Metric( Metric::Single, unsigned int domain_idx, unsigned int domain_id, std::string domain_name, unsigned int counter_idx, std::string counter_name, bool self ) :
     type( Metric::Single::value ),
     domain_idx( domain_idx ),
     domain_id( domain_id ),
     domain_name( domain_name ),
     counter_idx( counter_idx ),
-    counter_name( counter_name )
+    counter_name( counter_name ),
+    self( self )
 {
 }
 
 
-Metric::Metric( Metric::DomainTotal, unsigned int domain_idx, unsigned int domain_id, std::string domain_name ) :
+Metric::Metric( Metric::DomainTotal, unsigned int domain_idx, unsigned int domain_id, std::string domain_name, bool self ) :
     type( Metric::DomainTotal::value ),
     domain_idx( domain_idx ),
     domain_id( domain_id ),
     domain_name( domain_name ),
     counter_idx( 0 ),
-    counter_name( "TOTAL" )
+    counter_name( "TOTAL" ),
+    self( self )
 {
 }
 
@@ -47,18 +78,42 @@ Metric::Metric( Metric::Total ) :
 }
 
 
+Metric::Metric( Metric::Plugin, SamplerHealth::Value value ) :
+    type( Metric::Plugin::value ),
+    domain_idx( 0 ),
+    domain_id( ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_END ),
+    domain_name( "PLUGIN" ),
+    counter_idx( value ),
+    counter_name( SamplerHealth::names[ value ] )
+{
+}
+
+
+Metric::Metric( Metric::Efficiency, unsigned int value ) :
+    type( Metric::Efficiency::value ),
+    domain_idx( 0 ),
+    domain_id( ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_END ),
+    domain_name( "EFF" ),
+    counter_idx( value ),
+    counter_name( value < EfficiencySample::num_values
+                  ? EfficiencySample::names[ value ]
+                  : "avg_MHz_" + std::to_string( value - EfficiencySample::num_values ) )
+{
+}
+
+
 size_t
 Metric::id() const
 {
-    // Multi-index for (counter, domain, type) tuples
-    return ( this->counter_idx * EXTLIB_NUM_DOMAINS + this->domain_idx ) * ( 3 ) + this->type;
+    // Multi-index for (counter, domain, type, self) tuples
+    return ( ( this->counter_idx * EXTLIB_NUM_DOMAINS + this->domain_idx ) * ( 5 ) + this->type ) * 2 + this->self;
 }
 
 
 std::string
 Metric::name() const
 {
-    return this->domain_name + ":" + this->counter_name;
+    return this->domain_name + ":" + this->counter_name + ( this->self ? ":SELF" : "" );
 }
 
 
@@ -77,11 +132,43 @@ Metric::description() const
         case Total::value:
             ss << "Total energy consumption for all enabled meric domains";
             break;
+        case Plugin::value:
+            ss << SamplerHealth::descriptions[ this->counter_idx ];
+            break;
+        case Efficiency::value:
+            if ( this->counter_idx < EfficiencySample::num_values )
+            {
+                ss << EfficiencySample::descriptions[ this->counter_idx ];
+            }
+            else
+            {
+                ss << "Average frequency in the interval of the CPUs of socket " << this->counter_idx - EfficiencySample::num_values;
+            }
+            break;
+    }
+    if ( this->self )
+    {
+        ss << ", share of the traced processes by CPU time";
     }
     return ss.str();
 }
 
 
+std::string
+Metric::unit() const
+{
+    if ( this->isPlugin() )
+    {
+        return SamplerHealth::units[ this->counter_idx ];
+    }
+    if ( this->isEfficiency() )
+    {
+        return this->counter_idx < EfficiencySample::num_values ? EfficiencySample::units[ this->counter_idx ] : "MHz";
+    }
+    return "J";
+}
+
+
 bool
 Metric::operator==( const Metric& other ) const
 {
@@ -90,16 +177,26 @@ Metric::operator==( const Metric& other ) const
 
 
 double
-Metric::read( const ExtlibEnergyTimeStamp* ts ) const
+Metric::read( const EnergyReading& reading, const SamplerHealth& health, const EfficiencySample& efficiency ) const
 {
     switch ( this->type )
     {
         case Single::value:
-            return ts->domain_data[ this->domain_idx ].energy_per_counter[ this->counter_idx ];
+            return reading.domain_data[ this->domain_idx ].energy_per_counter[ this->counter_idx ];
         case DomainTotal::value:
-            return ts->domain_data[ this->domain_idx ].energy_total;
+            return reading.domain_data[ this->domain_idx ].energy_total;
         case Total::value:
-            return ts->domain_data->energy_total;
+            return reading.energy_total;
+        case Plugin::value:
+            return health.values[ this->counter_idx ];
+        case Efficiency::value:
+            if ( this->counter_idx < EfficiencySample::num_values )
+            {
+                return efficiency.values[ this->counter_idx ];
+            }
+            return this->counter_idx - EfficiencySample::num_values < efficiency.socket_MHz.size()
+                   ? efficiency.socket_MHz[ this->counter_idx - EfficiencySample::num_values ]
+                   : NAN;
         default:
             return 0.;
     }
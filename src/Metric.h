@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include "EnergyBackend.h"
+
 #include <meric_ext.h>
 
 #include <chrono>
@@ -18,26 +20,85 @@
 
 namespace MericPlugin
 {
+/*
+ * Health of the sampler itself, recorded for each sample as the PLUGIN:<name> metrics.
+ * Computed from the timestamps the sampling loop takes anyway.
+ */
+struct SamplerHealth
+{
+    enum Value : unsigned int
+    {
+        read_latency,    // Duration of the backend read, in s
+        sample_lateness, // Delay of the sample behind its scheduled deadline, in s
+        missed_ticks,    // Number of whole intervals skipped before this sample
+        buffer_bytes,    // Memory allocated for the recorded samples
+        reconfigured,    // Number of reconfigurations since the previous sample
+        num_values
+    };
+
+    static const char* const names[ num_values ];
+    static const char* const units[ num_values ];
+    static const char* const descriptions[ num_values ];
+
+    double values[ num_values ] = {};
+};
+
+
+/*
+ * Efficiency of the node in the interval of a sample, recorded as the EFF:<name> metrics.
+ * Read by EfficiencyCounters in the same iteration as the energy counters.
+ */
+struct EfficiencySample
+{
+    enum Value : unsigned int
+    {
+        avg_MHz,      // Average frequency of all CPUs
+        Ginstr_per_s, // Instructions retired by all CPUs
+        IPC,          // Instructions per cycle of all CPUs
+        J_per_Ginstr, // Energy of the CPU domain per instruction
+        num_values
+    };
+
+    static const char* const names[ num_values ];
+    static const char* const units[ num_values ];
+    static const char* const descriptions[ num_values ];
+
+    double              values[ num_values ] = {};
+    std::vector<double> socket_MHz; // Average frequency per socket, the EFF:avg_MHz_<socket> metrics
+};
+
+
 struct Metric
 {
     using Total       = std::integral_constant<unsigned, 0>;
     using DomainTotal = std::integral_constant<unsigned, 1>;
     using Single      = std::integral_constant<unsigned, 2>;
+    using Plugin      = std::integral_constant<unsigned, 3>;
+    using Efficiency  = std::integral_constant<unsigned, 4>;
 
     Metric( Single,
             unsigned int domain_idx,
             unsigned int domain_id,
             std::string  domain_name,
             unsigned int counter_idx,
-            std::string  counter_name );
+            std::string  counter_name,
+            bool         self = false );
 
     Metric ( DomainTotal,
              unsigned int domain_idx,
              unsigned int domain_id,
-             std::string  domain_name );
+             std::string  domain_name,
+             bool         self = false );
 
     Metric ( Total );
 
+    Metric ( Plugin,
+             SamplerHealth::Value value );
+
+    // EfficiencySample::Value, or EfficiencySample::num_values + socket for avg_MHz_<socket>
+    Metric ( Efficiency,
+             unsigned int value );
+
     Metric( const Metric& ) = delete;
 
     /* copy-assign */
@@ -63,8 +124,13 @@ struct Metric
     std::string
     description() const;
 
+    std::string
+    unit() const;
+
     double
-    read( const ExtlibEnergyTimeStamp* ts ) const;
+    read( const EnergyReading&    reading,
+          const SamplerHealth&    health,
+          const EfficiencySample& efficiency ) const;
 
     bool
     isSingle() const
@@ -81,13 +147,32 @@ struct Metric
     {
         return type == Total::value;
     };
+    bool
+    isPlugin() const
+    {
+        return type == Plugin::value;
+    };
+    bool
+    isEfficiency() const
+    {
+        return type == Efficiency::value;
+    };
+    // Energy in J, which is accumulated, resampled and summarized as such
+    bool
+    isEnergy() const
+    {
+        return type <= Single::value;
+    };
 
     unsigned int type;
-    unsigned int domain_idx;  // Index in ExtlibEnergyTimeStamp.domain_data array
+    unsigned int domain_idx;  // Index in EnergyReading.domain_data array
     unsigned int domain_id;   // Domain Id, i.e. value in the ExtlibEnergy::Domains enum
     std::string  domain_name;
-    unsigned int counter_idx; // Index in ExtlibEnergyTimeStamp.domain_data[domain_idx].energy_per_counter array
+    unsigned int counter_idx; // Index in EnergyReading.domain_data[domain_idx].energy_per_counter array,
+                              // or in SamplerHealth.values for PLUGIN metrics,
+                              // or in EfficiencySample.values for EFF metrics
     std::string  counter_name;
+    bool         self = false; // Only the share of the traced processes, the <domain>:<counter>:SELF metrics
 };
 }
 
@@ -97,7 +182,7 @@ namespace std
 inline ostream&
 operator<<( ostream& s, const MericPlugin::Metric& metric )
 {
-    s << "(" << metric.domain_name << ":" << metric.counter_name << ")";
+    s << "(" << metric.name() << ")";
     return s;
 }
 
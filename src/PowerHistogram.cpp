@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "PowerHistogram.h"
+
+
+namespace MericPlugin
+{
+constexpr int          PowerHistogram::min_exponent;
+constexpr int          PowerHistogram::max_exponent;
+constexpr unsigned int PowerHistogram::sub_buckets;
+constexpr std::size_t  PowerHistogram::num_buckets;
+
+
+double
+PowerHistogram::lower_bound( std::size_t bucket )
+{
+    if ( bucket == 0 )
+    {
+        return 0.;
+    }
+    const int    exponent = min_exponent + int( bucket / sub_buckets );
+    const double sub      = bucket % sub_buckets;
+    return std::ldexp( 0.5 + sub / ( 2. * sub_buckets ), exponent );
+}
+
+
+double
+PowerHistogram::upper_bound( std::size_t bucket )
+{
+    if ( bucket == num_buckets - 1 )
+    {
+        return INFINITY;
+    }
+    const int    exponent = min_exponent + int( bucket / sub_buckets );
+    const double sub      = bucket % sub_buckets + 1;
+    return std::ldexp( 0.5 + sub / ( 2. * sub_buckets ), exponent );
+}
+
+
+double
+PowerHistogram::share_above( double power ) const
+{
+    if ( total_seconds <= 0. )
+    {
+        return 0.;
+    }
+    double above = 0.;
+    for ( std::size_t b = bucket( power ) + 1; b < num_buckets; ++b )
+    {
+        above += seconds[ b ];
+    }
+    return above / total_seconds;
+}
+
+
+double
+PowerHistogram::percentile( double p ) const
+{
+    const double target = p * total_seconds;
+    double       below  = 0.;
+    for ( std::size_t b = 0; b < num_buckets; ++b )
+    {
+        below += seconds[ b ];
+        if ( below >= target && seconds[ b ] > 0. )
+        {
+            return upper_bound( b );
+        }
+    }
+    return 0.;
+}
+}
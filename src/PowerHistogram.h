@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+
+namespace MericPlugin
+{
+/*
+ * Time-weighted histogram of power with logarithmic buckets, in the style of HDR histograms:
+ * every power of two is split into `sub_buckets` linear buckets, so the relative width of a
+ * bucket is at most 1 / sub_buckets. Adding a value is O(1), and the memory is fixed.
+ * Values at or below min_power, including negative ones, are counted in the first bucket,
+ * values at or above max_power in the last one.
+ */
+class PowerHistogram
+{
+public:
+    static constexpr int          min_exponent = -10; // min_power = 2^-11 W, about 0.5 mW
+    static constexpr int          max_exponent = 20;  // max_power = 2^20 W, about 1 MW
+    static constexpr unsigned int sub_buckets  = 32;
+    static constexpr std::size_t  num_buckets  = ( max_exponent - min_exponent + 1 ) * sub_buckets;
+
+    PowerHistogram() :
+        seconds( num_buckets, 0. )
+    {
+    }
+
+    // Add `duration` seconds spent at `power` Watts
+    inline void
+    add( double power,
+         double duration )
+    {
+        seconds[ bucket( power ) ] += duration;
+        total_seconds              += duration;
+    }
+
+    static std::size_t
+    bucket( double power )
+    {
+        int          exponent;
+        const double mantissa = std::frexp( power, &exponent ); // power = mantissa * 2^exponent, mantissa in [0.5, 1)
+        if ( !( power > 0. ) || exponent < min_exponent )
+        {
+            return 0;
+        }
+        if ( exponent > max_exponent || std::isinf( power ) )
+        {
+            return num_buckets - 1;
+        }
+        const auto sub = static_cast<std::size_t>( ( mantissa - 0.5 ) * 2. * sub_buckets );
+        return ( exponent - min_exponent ) * sub_buckets + sub;
+    }
+
+    // Lower and upper power bound of a bucket
+    static double
+    lower_bound( std::size_t bucket );
+
+    static double
+    upper_bound( std::size_t bucket );
+
+    double
+    bucket_seconds( std::size_t bucket ) const
+    {
+        return seconds[ bucket ];
+    }
+
+    double
+    total() const
+    {
+        return total_seconds;
+    }
+
+    // Share of the time spent above `power`, up to the resolution of the buckets
+    double
+    share_above( double power ) const;
+
+    // The power below which the share `p` of the time was spent, as the upper bound of its bucket
+    double
+    percentile( double p ) const;
+
+private:
+    std::vector<double> seconds;
+    double              total_seconds = 0.;
+};
+}
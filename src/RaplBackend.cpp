@@ -0,0 +1,269 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "RaplBackend.h"
+
+#include <scorep/plugin/log.hpp>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+
+using scorep::plugin::logging;
+
+namespace MericPlugin
+{
+static const unsigned int rapl_domain = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_RAPL;
+
+// Assumed maximum power of zones without a constraint_0_max_power_uw, generous for a package
+static const std::uint64_t default_max_power_uw = 500000000;
+
+
+static std::string
+read_line( const std::string& path )
+{
+    std::ifstream file( path );
+    std::string   line;
+    std::getline( file, line );
+    return line;
+}
+
+
+// The zone directories in `sysfs_root`, sorted
+static std::vector<std::string>
+zone_dirs( const std::string& sysfs_root )
+{
+    std::vector<std::string> dirs;
+    if ( DIR* root = opendir( sysfs_root.c_str() ) )
+    {
+        while ( const dirent* entry = readdir( root ) )
+        {
+            if ( std::strncmp( entry->d_name, "intel-rapl:", 11 ) == 0 )
+            {
+                dirs.emplace_back( entry->d_name );
+            }
+        }
+        closedir( root );
+    }
+    std::sort( dirs.begin(), dirs.end() );
+    return dirs;
+}
+
+
+static std::uint64_t
+zone_max_power_uw( const std::string& path )
+{
+    const auto max_power = std::strtoull( read_line( path + "/constraint_0_max_power_uw" ).c_str(), nullptr, 10 );
+    return max_power > 0 ? max_power : default_max_power_uw;
+}
+
+
+// The time a zone takes to wrap at its maximum power, uJ / uW = s
+static std::chrono::microseconds
+wrap_time( std::uint64_t max_energy_range_uj, std::uint64_t max_power_uw )
+{
+    return std::chrono::microseconds( std::int64_t( double( max_energy_range_uj ) / max_power_uw * 1e6 ) );
+}
+
+
+// The package part of a top-level zone name: "package-1" -> "1", "package-0-die-1" -> "0_DIE_1".
+// Empty for zones that are not per package, like "psys".
+static std::string
+package_suffix( const std::string& zone_name )
+{
+    unsigned int package, die;
+    char         rest;
+    if ( std::sscanf( zone_name.c_str(), "package-%u-die-%u%c", &package, &die, &rest ) == 2 )
+    {
+        return std::to_string( package ) + "_DIE_" + std::to_string( die );
+    }
+    if ( std::sscanf( zone_name.c_str(), "package-%u%c", &package, &rest ) == 1 )
+    {
+        return std::to_string( package );
+    }
+    return "";
+}
+
+
+// Map a zone directory like "intel-rapl:1:0" with the zone name "dram" to "DRAM_1", named
+// after the package of its parent zone "intel-rapl:1"
+static std::string
+counter_name_for_zone( const std::string& sysfs_root, const std::string& dir, const std::string& zone_name )
+{
+    std::string upper = zone_name;
+    std::transform( upper.begin(), upper.end(), upper.begin(), ::toupper );
+    const auto first_colon  = dir.find( ':' );
+    const auto second_colon = dir.find( ':', first_colon + 1 );
+    if ( second_colon == std::string::npos )
+    {
+        const std::string package = package_suffix( zone_name );
+        return package != "" ? "PCKG_" + package : upper;
+    }
+    std::string package = package_suffix( read_line( sysfs_root + "/" + dir.substr( 0, second_colon ) + "/name" ) );
+    if ( package == "" )
+    {
+        // The parent is not a package zone, use its index
+        package = dir.substr( first_colon + 1, second_colon - first_colon - 1 );
+    }
+    return upper + "_" + package;
+}
+
+
+RaplBackend::RaplBackend( const std::vector<unsigned int>& requested_domains, const std::string& sysfs_root )
+{
+    if ( std::find( requested_domains.begin(), requested_domains.end(), rapl_domain ) == requested_domains.end() )
+    {
+        return;
+    }
+
+    for ( const auto& dir : zone_dirs( sysfs_root ) )
+    {
+        const std::string path      = sysfs_root + "/" + dir;
+        const std::string zone_name = read_line( path + "/name" );
+        const std::string max_range = read_line( path + "/max_energy_range_uj" );
+        const int         fd        = open( ( path + "/energy_uj" ).c_str(), O_RDONLY );
+        if ( fd < 0 || zone_name == "" || max_range == "" )
+        {
+            logging::warn() << "Skipping RAPL zone " << path << ": " << ( fd < 0 ? std::strerror( errno ) : "incomplete zone" );
+            if ( fd >= 0 )
+            {
+                close( fd );
+            }
+            continue;
+        }
+        const std::string counter_name = counter_name_for_zone( sysfs_root, dir, zone_name );
+        zones.push_back( {
+            .counter_name        = counter_name,
+            .fd                  = fd,
+            .max_energy_range_uj = std::strtoull( max_range.c_str(), nullptr, 10 ),
+            .max_power_uw        = zone_max_power_uw( path ),
+            .last_uj             = 0,
+            .accumulated_uj      = 0,
+            .in_total            = counter_name.compare( 0, 5, "PCKG_" ) == 0 || counter_name.compare( 0, 5, "DRAM_" ) == 0
+        } );
+        zones.back().last_uj = read_energy_uj( zones.back() );
+    }
+    if ( zones.empty() )
+    {
+        logging::warn() << "Domain 'RAPL' was requested but no RAPL zones were found in " << sysfs_root;
+    }
+}
+
+
+RaplBackend::~RaplBackend()
+{
+    for ( const auto& zone : zones )
+    {
+        close( zone.fd );
+    }
+}
+
+
+std::unordered_map<std::string, Domain>
+RaplBackend::query_enabled_domains()
+{
+    if ( zones.empty() )
+    {
+        return {};
+    }
+    Domain domain = { .id = rapl_domain, .idx = rapl_domain, .counter_idx_by_name = {} };
+    for ( unsigned int counter_idx = 0; counter_idx < zones.size(); ++counter_idx )
+    {
+        domain.counter_idx_by_name.emplace( zones[ counter_idx ].counter_name, counter_idx );
+    }
+    return { { domain.name(), domain } };
+}
+
+
+std::chrono::microseconds
+RaplBackend::max_safe_interval() const
+{
+    std::chrono::microseconds safe( 0 );
+    for ( const auto& zone : zones )
+    {
+        const auto wrap = wrap_time( zone.max_energy_range_uj, zone.max_power_uw );
+        if ( safe.count() == 0 || wrap < safe )
+        {
+            safe = wrap;
+        }
+    }
+    return safe;
+}
+
+
+std::chrono::microseconds
+RaplBackend::max_safe_interval( const std::string& sysfs_root )
+{
+    std::chrono::microseconds safe( 0 );
+    for ( const auto& dir : zone_dirs( sysfs_root ) )
+    {
+        const std::string path      = sysfs_root + "/" + dir;
+        const auto        max_range = std::strtoull( read_line( path + "/max_energy_range_uj" ).c_str(), nullptr, 10 );
+        if ( max_range == 0 )
+        {
+            continue;
+        }
+        const auto wrap = wrap_time( max_range, zone_max_power_uw( path ) );
+        if ( safe.count() == 0 || wrap < safe )
+        {
+            safe = wrap;
+        }
+    }
+    return safe;
+}
+
+
+std::uint64_t
+RaplBackend::read_energy_uj( const Zone& zone ) const
+{
+    char          buffer[ 32 ];
+    const ssize_t n = pread( zone.fd, buffer, sizeof( buffer ) - 1, 0 );
+    if ( n <= 0 )
+    {
+        throw std::runtime_error( "Could not read RAPL counter " + zone.counter_name );
+    }
+    buffer[ n ] = '\0';
+    return std::strtoull( buffer, nullptr, 10 );
+}
+
+
+void
+RaplBackend::read( EnergyReading& reading )
+{
+    reading.domain_data.resize( EXTLIB_NUM_DOMAINS );
+    auto& domain = reading.domain_data[ rapl_domain ];
+    domain.energy_per_counter.resize( zones.size() );
+    domain.energy_total  = 0.;
+    reading.energy_total = 0.;
+
+    for ( std::size_t counter_idx = 0; counter_idx < zones.size(); ++counter_idx )
+    {
+        Zone&               zone    = zones[ counter_idx ];
+        const std::uint64_t current = read_energy_uj( zone );
+        // The counter wraps around at max_energy_range_uj
+        zone.accumulated_uj += current >= zone.last_uj ? current - zone.last_uj
+                                                      : zone.max_energy_range_uj - zone.last_uj + current;
+        zone.last_uj = current;
+
+        const double joules = zone.accumulated_uj * 1e-6;
+        domain.energy_per_counter[ counter_idx ] = joules;
+        if ( zone.in_total )
+        {
+            domain.energy_total += joules;
+        }
+    }
+    reading.energy_total = domain.energy_total;
+}
+}
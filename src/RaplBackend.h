@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include "EnergyBackend.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace MericPlugin
+{
+/*
+ * Energy backend reading RAPL directly from the Linux powercap interface.
+ *
+ * The energy_uj files of all zones are opened once, and each read is one pread per zone:
+ * sysfs has no call that reads several files at once. Counter names follow the RAPL names
+ * used with extlib: PCKG_<n>, DRAM_<n>, CORE_<n> and UNCORE_<n>, where <n> is the package.
+ * On CPUs with one zone per die, <n> is <package>_DIE_<die>. The platform zone is PSYS.
+ * RAPL:TOTAL is the sum of the package and DRAM counters, since the other zones overlap
+ * with them.
+ */
+class RaplBackend : public EnergyBackend
+{
+public:
+    // `sysfs_root` usually is /sys/class/powercap
+    RaplBackend( const std::vector<unsigned int>& requested_domains,
+                 const std::string&               sysfs_root );
+
+    ~RaplBackend();
+
+    RaplBackend( const RaplBackend& ) = delete;
+    RaplBackend&
+    operator=( const RaplBackend& ) = delete;
+
+    std::unordered_map<std::string, Domain>
+    query_enabled_domains() override;
+
+    void
+    read( EnergyReading& reading ) override;
+
+    // The time the fastest zone takes to wrap at its maximum power
+    std::chrono::microseconds
+    max_safe_interval() const override;
+
+    // max_safe_interval() of the zones in `sysfs_root`, without opening them for reading.
+    // Zero if there are no readable zones.
+    static std::chrono::microseconds
+    max_safe_interval( const std::string& sysfs_root );
+
+private:
+    struct Zone
+    {
+        std::string   counter_name;
+        int           fd;
+        std::uint64_t max_energy_range_uj;
+        std::uint64_t max_power_uw;
+        std::uint64_t last_uj;
+        std::uint64_t accumulated_uj;
+        bool          in_total;
+    };
+
+    std::uint64_t
+    read_energy_uj( const Zone& zone ) const;
+
+    std::vector<Zone> zones;
+};
+}
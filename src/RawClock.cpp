@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "RawClock.h"
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <cpuid.h>
+#endif
+
+
+namespace MericPlugin
+{
+const bool RawClock::tsc = RawClock::invariant_tsc();
+
+
+bool
+RawClock::invariant_tsc()
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    // CPUID.80000007H:EDX[8], the invariant TSC flag of Intel and AMD
+    unsigned int eax, ebx, ecx, edx;
+    return __get_cpuid( 0x80000007, &eax, &ebx, &ecx, &edx ) && ( edx & ( 1u << 8 ) );
+#else
+    return false;
+#endif
+}
+}
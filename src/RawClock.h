@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#endif
+
+
+namespace MericPlugin
+{
+/*
+ * A raw timestamp that costs a few ns, for stamping samples inside the read window.
+ * Reads the TSC if it is invariant, i.e. runs at a constant rate in all P- and C-states,
+ * and CLOCK_MONOTONIC_RAW in ns otherwise. The values only increase linearly with time, the
+ * caller maps them to a real clock with timestamps of both clocks taken at the same time.
+ */
+class RawClock
+{
+public:
+    static std::uint64_t
+    now()
+    {
+#if defined( __x86_64__ ) || defined( __i386__ )
+        if ( tsc )
+        {
+            return __rdtsc();
+        }
+#endif
+        struct timespec ts;
+        clock_gettime( CLOCK_MONOTONIC_RAW, &ts );
+        return std::uint64_t( ts.tv_sec ) * 1000000000ULL + ts.tv_nsec;
+    }
+
+    static bool
+    uses_tsc()
+    {
+        return tsc;
+    }
+
+private:
+    static bool
+    invariant_tsc();
+
+    static const bool tsc;
+};
+}
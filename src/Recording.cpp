@@ -0,0 +1,329 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "Recording.h"
+
+#include <scorep/plugin/log.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+
+using scorep::plugin::logging;
+
+namespace MericPlugin
+{
+RecordingBackend::RecordingBackend( std::unique_ptr<EnergyBackend>&& backend, const std::string& path ) :
+    path( path ),
+    file( std::fopen( path.c_str(), "wb" ) )
+{
+    if ( !file )
+    {
+        throw std::runtime_error( "Could not open recording '" + path + "': " + std::strerror( errno ) );
+    }
+    this->backend = std::move( backend );
+    // Keep the writes out of the sampling loop as much as possible
+    std::setvbuf( file, nullptr, _IOFBF, 1 << 20 );
+}
+
+
+RecordingBackend::~RecordingBackend()
+{
+    if ( std::fclose( file ) != 0 )
+    {
+        logging::warn() << "Could not write recording '" << path << "'";
+    }
+}
+
+
+std::unordered_map<std::string, Domain>
+RecordingBackend::query_enabled_domains()
+{
+    return backend->query_enabled_domains();
+}
+
+
+void
+RecordingBackend::calc_energy_consumption( const EnergyReading& begin, const EnergyReading& end, EnergyReading& result ) const
+{
+    backend->calc_energy_consumption( begin, end, result );
+}
+
+
+void
+RecordingBackend::write_header()
+{
+    for ( const auto& item : backend->query_enabled_domains() )
+    {
+        domains.push_back( item.second );
+    }
+    std::sort( domains.begin(), domains.end(), []( const Domain& a, const Domain& b ){
+            return a.idx < b.idx;
+        } );
+
+    auto write_u32 = [ this ]( std::uint32_t value ){
+                         std::fwrite( &value, sizeof( value ), 1, file );
+                     };
+    std::fwrite( RecordingFormat::magic, sizeof( RecordingFormat::magic ), 1, file );
+    write_u32( RecordingFormat::version );
+    write_u32( domains.size() );
+    std::size_t num_values = 1;
+    for ( const auto& domain : domains )
+    {
+        std::vector<std::string> counter_names( domain.counter_idx_by_name.size() );
+        for ( const auto& counter : domain.counter_idx_by_name )
+        {
+            counter_names.at( counter.second ) = counter.first;
+        }
+        write_u32( domain.id );
+        write_u32( domain.idx );
+        write_u32( counter_names.size() );
+        for ( const auto& name : counter_names )
+        {
+            write_u32( name.size() );
+            std::fwrite( name.data(), 1, name.size(), file );
+        }
+        num_values += 1 + counter_names.size();
+    }
+    write_u32( num_values );
+    record.resize( num_values );
+    header_written = true;
+}
+
+
+void
+RecordingBackend::read( EnergyReading& reading )
+{
+    const auto begin = std::chrono::steady_clock::now();
+    backend->read( reading );
+    const auto end = std::chrono::steady_clock::now();
+
+    if ( !header_written )
+    {
+        write_header();
+        first_read = begin;
+    }
+
+    std::size_t value = 0;
+    for ( const auto& domain : domains )
+    {
+        const auto& data = reading.domain_data[ domain.idx ];
+        record[ value++ ] = data.energy_total;
+        for ( std::size_t counter = 0; counter < domain.counter_idx_by_name.size(); ++counter )
+        {
+            record[ value++ ] = counter < data.energy_per_counter.size() ? data.energy_per_counter[ counter ] : 0.;
+        }
+    }
+    record[ value ] = reading.energy_total;
+
+    const std::uint64_t times[ 2 ] = {
+        std::uint64_t( std::chrono::duration_cast<std::chrono::nanoseconds>( begin - first_read ).count() ),
+        std::uint64_t( std::chrono::duration_cast<std::chrono::nanoseconds>( end - begin ).count() )
+    };
+    std::fwrite( times, sizeof( times ), 1, file );
+    std::fwrite( record.data(), sizeof( double ), record.size(), file );
+}
+
+
+ReplayBackend::ReplayBackend( const std::vector<unsigned int>& requested_domains, const std::string& path, double speed ) :
+    speed( speed )
+{
+    int fd = open( path.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    {
+        throw std::runtime_error( "Could not open recording '" + path + "': " + std::strerror( errno ) );
+    }
+    struct stat st;
+    if ( fstat( fd, &st ) != 0 || st.st_size == 0 )
+    {
+        close( fd );
+        throw std::runtime_error( "Recording '" + path + "' is empty" );
+    }
+    size = st.st_size;
+    void* addr = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if ( addr == MAP_FAILED )
+    {
+        throw std::runtime_error( "Could not map recording '" + path + "': " + std::strerror( errno ) );
+    }
+    memory = static_cast<const unsigned char*>( addr );
+
+    std::size_t offset    = 0;
+    auto        read_u32  = [ & ](){
+                                if ( offset + sizeof( std::uint32_t ) > size )
+                                {
+                                    throw std::runtime_error( "Recording '" + path + "' is truncated" );
+                                }
+                                std::uint32_t value;
+                                std::memcpy( &value, memory + offset, sizeof( value ) );
+                                offset += sizeof( value );
+                                return value;
+                            };
+    try
+    {
+        if ( size < sizeof( RecordingFormat::magic )
+             || std::memcmp( memory, RecordingFormat::magic, sizeof( RecordingFormat::magic ) ) != 0 )
+        {
+            throw std::runtime_error( "'" + path + "' is not a meric recording" );
+        }
+        offset = sizeof( RecordingFormat::magic );
+        if ( read_u32() != RecordingFormat::version )
+        {
+            throw std::runtime_error( "Recording '" + path + "' has an unsupported version" );
+        }
+        const std::uint32_t num_domains  = read_u32();
+        std::size_t         value_offset = 0;
+        for ( std::uint32_t i = 0; i < num_domains; ++i )
+        {
+            RecordedDomain recorded;
+            recorded.domain.id    = read_u32();
+            recorded.domain.idx   = read_u32();
+            recorded.num_counters = read_u32();
+            recorded.value_offset = value_offset;
+            for ( std::size_t counter = 0; counter < recorded.num_counters; ++counter )
+            {
+                const std::uint32_t length = read_u32();
+                if ( offset + length > size )
+                {
+                    throw std::runtime_error( "Recording '" + path + "' is truncated" );
+                }
+                recorded.domain.counter_idx_by_name.emplace( std::string( reinterpret_cast<const char*>( memory + offset ), length ), counter );
+                offset += length;
+            }
+            recorded.enabled = std::find( requested_domains.begin(), requested_domains.end(), recorded.domain.id ) != requested_domains.end()
+                               && domain_name_by_id.count( recorded.domain.id ) == 1
+                               && recorded.domain.idx < EXTLIB_NUM_DOMAINS;
+            value_offset += 1 + recorded.num_counters;
+            recorded_domains.push_back( std::move( recorded ) );
+        }
+        num_values = read_u32();
+        if ( num_values != value_offset + 1 )
+        {
+            throw std::runtime_error( "Recording '" + path + "' has an inconsistent header" );
+        }
+    }
+    catch ( ... )
+    {
+        munmap( const_cast<unsigned char*>( memory ), size );
+        throw;
+    }
+    all_domains_enabled = std::all_of( recorded_domains.begin(), recorded_domains.end(), []( const RecordedDomain& recorded ){
+            return recorded.enabled;
+        } );
+    records_offset = offset;
+    record_size    = 2 * sizeof( std::uint64_t ) + num_values * sizeof( double );
+    records        = ( size - records_offset ) / record_size;
+    if ( records == 0 )
+    {
+        logging::warn() << "Recording '" << path << "' has no readings";
+    }
+}
+
+
+ReplayBackend::~ReplayBackend()
+{
+    munmap( const_cast<unsigned char*>( memory ), size );
+}
+
+
+std::unordered_map<std::string, Domain>
+ReplayBackend::query_enabled_domains()
+{
+    std::unordered_map<std::string, Domain> domains;
+    for ( const auto& recorded : recorded_domains )
+    {
+        if ( recorded.enabled )
+        {
+            domains.emplace( recorded.domain.name(), recorded.domain );
+        }
+    }
+    return domains;
+}
+
+
+const unsigned char*
+ReplayBackend::record( std::size_t index ) const
+{
+    return memory + records_offset + index * record_size;
+}
+
+
+void
+ReplayBackend::read( EnergyReading& reading )
+{
+    reading.domain_data.resize( EXTLIB_NUM_DOMAINS );
+    reading.energy_total = 0.;
+    if ( records == 0 )
+    {
+        return;
+    }
+
+    std::size_t index = std::min( next_record, records - 1 );
+    if ( speed > 0. )
+    {
+        // The latest record at the scaled replay time
+        const auto now = std::chrono::steady_clock::now();
+        if ( !started )
+        {
+            replay_start = now;
+            started      = true;
+        }
+        const double elapsed_ns = std::chrono::duration<double, std::nano>( now - replay_start ).count() * speed;
+        while ( index + 1 < records )
+        {
+            std::uint64_t timestamp_ns;
+            std::memcpy( &timestamp_ns, record( index + 1 ), sizeof( timestamp_ns ) );
+            if ( timestamp_ns > elapsed_ns )
+            {
+                break;
+            }
+            ++index;
+        }
+        std::uint64_t latency_ns;
+        std::memcpy( &latency_ns, record( index ) + sizeof( std::uint64_t ), sizeof( latency_ns ) );
+        std::this_thread::sleep_for( std::chrono::nanoseconds( std::uint64_t( latency_ns / speed ) ) );
+    }
+    if ( index + 1 == records && next_record < records )
+    {
+        logging::warn() << "Replay reached the end of the recording, the energy stops increasing";
+    }
+    next_record = index + 1;
+
+    const unsigned char* values = record( index ) + 2 * sizeof( std::uint64_t );
+    auto                 value  = [ values ]( std::size_t i ){
+                                      double v;
+                                      std::memcpy( &v, values + i * sizeof( double ), sizeof( double ) );
+                                      return v;
+                                  };
+    for ( const auto& recorded : recorded_domains )
+    {
+        if ( !recorded.enabled )
+        {
+            continue;
+        }
+        auto& data = reading.domain_data[ recorded.domain.idx ];
+        data.energy_total = value( recorded.value_offset );
+        data.energy_per_counter.resize( recorded.num_counters );
+        for ( std::size_t counter = 0; counter < recorded.num_counters; ++counter )
+        {
+            data.energy_per_counter[ counter ] = value( recorded.value_offset + 1 + counter );
+        }
+        reading.energy_total += data.energy_total;
+    }
+    if ( all_domains_enabled )
+    {
+        reading.energy_total = value( num_values - 1 );
+    }
+}
+}
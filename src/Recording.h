@@ -0,0 +1,136 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include "EnergyBackend.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace MericPlugin
+{
+/*
+ * Recordings of raw backend readings, to replay a measurement reproducibly.
+ *
+ * File layout, native byte order:
+ *
+ *     char[8] magic, uint32_t version, uint32_t num_domains
+ *     per domain: uint32_t id, uint32_t idx, uint32_t num_counters,
+ *                 per counter: uint32_t name length, name
+ *     uint32_t num_values
+ *     records: uint64_t timestamp_ns, uint64_t latency_ns, double[num_values]
+ *
+ * Timestamps are relative to the first read. The values of a record are, for each domain
+ * in order, its total and its counters, followed by the total of all domains.
+ */
+namespace RecordingFormat
+{
+constexpr char          magic[ 8 ] = { 'M', 'E', 'R', 'I', 'C', 'R', 'R', '\0' };
+constexpr std::uint32_t version    = 1;
+}
+
+
+// Passes all reads through to another backend, and appends them to a recording
+class RecordingBackend : public EnergyBackend
+{
+public:
+    // Takes over `backend` only if the recording could be opened
+    RecordingBackend( std::unique_ptr<EnergyBackend>&& backend,
+                      const std::string&               path );
+
+    ~RecordingBackend();
+
+    std::unordered_map<std::string, Domain>
+    query_enabled_domains() override;
+
+    void
+    read( EnergyReading& reading ) override;
+
+    void
+    calc_energy_consumption( const EnergyReading& begin,
+                             const EnergyReading& end,
+                             EnergyReading&       result ) const override;
+
+    std::chrono::microseconds
+    max_safe_interval() const override
+    {
+        return backend->max_safe_interval();
+    }
+
+private:
+    void
+    write_header();
+
+    std::unique_ptr<EnergyBackend>        backend;
+    std::string                           path;
+    std::FILE*                            file;
+    std::vector<Domain>                   domains; // In the order of the recorded values
+    std::vector<double>                   record;
+    std::chrono::steady_clock::time_point first_read;
+    bool                                  header_written = false;
+};
+
+
+// Feeds the readings of a recording back, at the recorded speed or faster
+class ReplayBackend : public EnergyBackend
+{
+public:
+    // `speed` scales the recorded time, 0 replays one record per read without waiting
+    ReplayBackend( const std::vector<unsigned int>& requested_domains,
+                   const std::string&               path,
+                   double                           speed );
+
+    ~ReplayBackend();
+
+    ReplayBackend( const ReplayBackend& ) = delete;
+    ReplayBackend&
+    operator=( const ReplayBackend& ) = delete;
+
+    std::unordered_map<std::string, Domain>
+    query_enabled_domains() override;
+
+    void
+    read( EnergyReading& reading ) override;
+
+    std::size_t
+    num_records() const
+    {
+        return records;
+    }
+
+private:
+    struct RecordedDomain
+    {
+        Domain      domain;
+        std::size_t value_offset; // Offset of the domain total in a record's values
+        std::size_t num_counters;
+        bool        enabled;
+    };
+
+    const unsigned char*
+    record( std::size_t index ) const;
+
+    std::size_t                           size;
+    const unsigned char*                  memory;
+    std::size_t                           records_offset;
+    std::size_t                           record_size;
+    std::size_t                           num_values;
+    std::size_t                           records;
+    std::vector<RecordedDomain>           recorded_domains;
+    bool                                  all_domains_enabled;
+    double                                speed;
+    std::size_t                           next_record = 0;
+    std::chrono::steady_clock::time_point replay_start;
+    bool                                  started = false;
+};
+}
@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "SampleTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+
+namespace MericPlugin
+{
+void
+SampleTable::reset( std::size_t num_metrics )
+{
+    num_metrics_ = num_metrics;
+    timestamps.clear();
+    values_.clear();
+}
+
+
+std::size_t
+SampleTable::bytes() const
+{
+    return timestamps.capacity() * sizeof( scorep::chrono::ticks ) + values_.capacity() * sizeof( double );
+}
+
+
+void
+SampleTable::copy_column( std::size_t metric, double* column ) const
+{
+    const double* src = values_.data() + metric;
+    for ( std::size_t row = 0; row < timestamps.size(); ++row )
+    {
+        column[ row ] = src[ row * num_metrics_ ];
+    }
+}
+
+
+void
+SampleTable::map_timestamps( std::uint64_t origin_in, std::uint64_t origin_out, double scale )
+{
+    for ( auto& timestamp : timestamps )
+    {
+        const auto offset = static_cast<std::int64_t>( std::uint64_t( timestamp.count() ) - origin_in );
+        timestamp = scorep::chrono::ticks( origin_out + std::llround( offset * scale ) );
+    }
+}
+
+
+std::vector<std::vector<SampleTable::TVPair> >
+SampleTable::materialize( unsigned int num_threads ) const
+{
+    std::vector<std::vector<TVPair> > columns( num_metrics_ );
+    num_threads = std::max( 1u, std::min<unsigned int>( num_threads, num_metrics_ ) );
+
+    // Each thread fills a contiguous range of metrics, walking the rows in memory order
+    auto fill = [ this, &columns ]( std::size_t begin, std::size_t end ){
+                    for ( std::size_t metric = begin; metric < end; ++metric )
+                    {
+                        columns[ metric ].resize( timestamps.size() );
+                    }
+                    for ( std::size_t row = 0; row < timestamps.size(); ++row )
+                    {
+                        const double* values = this->row( row );
+                        for ( std::size_t metric = begin; metric < end; ++metric )
+                        {
+                            columns[ metric ][ row ] = TVPair( timestamps[ row ], values[ metric ] );
+                        }
+                    }
+                };
+
+    std::vector<std::thread> threads;
+    const std::size_t        per_thread = ( num_metrics_ + num_threads - 1 ) / std::max<std::size_t>( num_threads, 1 );
+    for ( std::size_t begin = per_thread; begin < num_metrics_; begin += per_thread )
+    {
+        threads.emplace_back( fill, begin, std::min( begin + per_thread, num_metrics_ ) );
+    }
+    fill( 0, std::min( per_thread, num_metrics_ ) );
+    for ( auto& thread : threads )
+    {
+        thread.join();
+    }
+    return columns;
+}
+
+
+SampleTable
+SampleTable::resample( double origin, double step, const std::vector<std::size_t>& held_metrics ) const
+{
+    SampleTable result;
+    result.reset( num_metrics_ );
+    if ( timestamps.size() < 2 || step <= 0. )
+    {
+        return result;
+    }
+
+    const std::size_t   n = num_metrics_;
+    std::vector<double> bin( n, 0. );
+    const double*       latest = row( 0 );
+
+    // Grid interval k covers ( origin + ( k - 1 ) * step, origin + k * step ]
+    double      begin   = 2. * timestamps[ 0 ].count() - double( timestamps[ 1 ].count() );
+    double      k       = std::floor( ( begin - origin ) / step ) + 1.;
+    double      bin_end = origin + k * step;
+    bool        filled  = false;
+    const auto  emit    = [ & ](){
+                              for ( std::size_t metric : held_metrics )
+                              {
+                                  bin[ metric ] = latest[ metric ];
+                              }
+                              result.append( scorep::chrono::ticks( std::uint64_t( bin_end ) ), bin.data() );
+                              std::fill( bin.begin(), bin.end(), 0. );
+                              k      += 1.;
+                              bin_end = origin + k * step;
+                              filled  = false;
+                          };
+
+    for ( std::size_t r = 0; r < timestamps.size(); ++r )
+    {
+        const double  end    = timestamps[ r ].count();
+        const double* values = row( r );
+        latest = values;
+        if ( end <= begin )
+        {
+            // No time passed, the energy belongs to the current grid interval
+            for ( std::size_t metric = 0; metric < n; ++metric )
+            {
+                bin[ metric ] += values[ metric ];
+            }
+            filled = true;
+            continue;
+        }
+        const double inv_duration = 1. / ( end - begin );
+        while ( begin < end )
+        {
+            const double  segment_end = std::min( end, bin_end );
+            const double  fraction    = ( segment_end - begin ) * inv_duration;
+            double*       out         = bin.data();
+            // Walks the metrics of the row in memory order
+            for ( std::size_t metric = 0; metric < n; ++metric )
+            {
+                out[ metric ] += fraction * values[ metric ];
+            }
+            filled = true;
+            begin  = segment_end;
+            if ( segment_end >= bin_end )
+            {
+                emit();
+            }
+        }
+    }
+    if ( filled )
+    {
+        emit();
+    }
+    return result;
+}
+}
@@ -0,0 +1,134 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include <scorep/chrono/chrono.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace MericPlugin
+{
+/*
+ * Samples of all metrics, stored as one row per sampling iteration.
+ * All metrics of a row share the same timestamp, so the sampler appends a single
+ * timestamp and one contiguous block of values per iteration.
+ */
+class SampleTable
+{
+public:
+    using TVPair = std::pair<scorep::chrono::ticks, double>;
+
+    void
+    reset( std::size_t num_metrics );
+
+    inline void
+    append( scorep::chrono::ticks timestamp,
+            const double*         values )
+    {
+        timestamps.push_back( timestamp );
+        values_.insert( values_.end(), values, values + num_metrics_ );
+    }
+
+    std::size_t
+    size() const
+    {
+        return timestamps.size();
+    }
+
+    std::size_t
+    num_metrics() const
+    {
+        return num_metrics_;
+    }
+
+    // Memory currently allocated for the samples
+    std::size_t
+    bytes() const;
+
+    scorep::chrono::ticks
+    timestamp( std::size_t row ) const
+    {
+        return timestamps[ row ];
+    }
+
+    double
+    value( std::size_t row,
+           std::size_t metric ) const
+    {
+        return values_[ row * num_metrics_ + metric ];
+    }
+
+    const double*
+    row( std::size_t row ) const
+    {
+        return values_.data() + row * num_metrics_;
+    }
+
+    // Map the timestamps linearly to another clock: origin_out + ( t - origin_in ) * scale.
+    // The offsets are taken in integers, so that 64-bit clocks keep their resolution.
+    void
+    map_timestamps( std::uint64_t origin_in,
+                    std::uint64_t origin_out,
+                    double        scale );
+
+    // Copy the values of one metric into a contiguous column
+    void
+    copy_column( std::size_t metric,
+                 double*     column ) const;
+
+    // The time-value pairs of every metric, prepared by up to `num_threads` threads
+    std::vector<std::vector<TVPair> >
+    materialize( unsigned int num_threads ) const;
+
+    /*
+     * Resample onto the uniform grid origin + k * step, in ticks. Each row holds the
+     * energy since the previous row, which is redistributed onto the grid intervals in
+     * proportion to their overlap, so the total energy is conserved. A row of the result
+     * holds the energy of the grid interval ending at its timestamp. The first row is
+     * assumed to cover as much time as the second one.
+     * Metrics in `held_metrics` are not energies, they keep the latest value instead.
+     */
+    SampleTable
+    resample( double                          origin,
+              double                          step,
+              const std::vector<std::size_t>& held_metrics ) const;
+
+private:
+    std::size_t                        num_metrics_ = 0;
+    std::vector<scorep::chrono::ticks> timestamps;
+    std::vector<double>                values_;
+};
+
+
+// Write the readings of one metric to a Score-P cursor, or anything else with resize() and
+// write( ticks, double ). The cursor is resized once and the pairs are written one by one,
+// without conversion. NaN marks samples without a value, e.g. of masked domains, which are
+// left out.
+template <typename C>
+void
+write_readings( const std::vector<SampleTable::TVPair>& readings,
+                C&                                      cursor )
+{
+    const std::size_t num_values = std::count_if( readings.begin(), readings.end(), []( const SampleTable::TVPair& tvpair ){
+            return !std::isnan( tvpair.second );
+        } );
+    cursor.resize( num_values );
+    for ( const auto& tvpair : readings )
+    {
+        if ( !std::isnan( tvpair.second ) )
+        {
+            cursor.write( tvpair.first, tvpair.second );
+        }
+    }
+}
+}
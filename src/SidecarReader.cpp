@@ -0,0 +1,262 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "meric_sidecar.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+
+namespace MericPlugin
+{
+// Whether `count` elements of `element_size` bytes at the 8-byte aligned `offset` lie within
+// the first `size` bytes. Does not overflow, whatever a corrupted header holds.
+static bool
+fits( std::uint64_t offset, std::uint64_t count, std::uint64_t element_size, std::uint64_t size )
+{
+    return offset % 8 == 0 && offset <= size && count <= ( size - offset ) / element_size;
+}
+
+
+// Whether the last of the `num_metrics` columns, `column_stride` apart, lies within the file,
+// with each column in front of the next. fits() holds for the first column.
+static bool
+columns_fit( const SidecarFormat::Header& header, std::uint64_t size )
+{
+    const std::uint64_t column_size = header.num_samples * sizeof( double );
+    if ( header.num_metrics <= 1 || column_size == 0 )
+    {
+        return true;
+    }
+    return header.column_stride % 8 == 0 && header.column_stride >= column_size
+           && header.num_metrics - 1 <= ( size - header.values_offset - column_size ) / header.column_stride;
+}
+
+
+SidecarReader::SidecarReader( const std::string& path )
+{
+    int fd = open( path.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    {
+        throw std::runtime_error( "Could not open '" + path + "': " + std::strerror( errno ) );
+    }
+    struct stat st;
+    if ( fstat( fd, &st ) != 0 || std::size_t( st.st_size ) < sizeof( SidecarFormat::Header ) )
+    {
+        close( fd );
+        throw std::runtime_error( "'" + path + "' is not a meric side-car file" );
+    }
+    size = st.st_size;
+    void* addr = mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( addr == MAP_FAILED )
+    {
+        throw std::runtime_error( "Could not map '" + path + "': " + std::strerror( errno ) );
+    }
+    memory = static_cast<const unsigned char*>( addr );
+    header = reinterpret_cast<const SidecarFormat::Header*>( memory );
+
+    const bool valid = std::memcmp( header->magic, SidecarFormat::magic, sizeof( SidecarFormat::magic ) ) == 0
+                       && header->version == SidecarFormat::version
+                       && fits( header->metrics_offset, header->num_metrics, sizeof( SidecarFormat::MetricEntry ), size )
+                       && fits( header->timestamps_offset, header->num_samples, sizeof( std::uint64_t ), size )
+                       && fits( header->values_offset, header->num_samples, sizeof( double ), size )
+                       && columns_fit( *header, size );
+    if ( !valid )
+    {
+        munmap( const_cast<unsigned char*>( memory ), size );
+        throw std::runtime_error( "'" + path + "' is not a compatible meric side-car file" );
+    }
+
+    const auto* entries = reinterpret_cast<const SidecarFormat::MetricEntry*>( memory + header->metrics_offset );
+    for ( std::uint32_t i = 0; i < header->num_metrics; ++i )
+    {
+        names.emplace_back( entries[ i ].name, strnlen( entries[ i ].name, sizeof( entries[ i ].name ) ) );
+    }
+}
+
+
+SidecarReader::~SidecarReader()
+{
+    munmap( const_cast<unsigned char*>( memory ), size );
+}
+
+
+std::size_t
+SidecarReader::num_metrics() const
+{
+    return header->num_metrics;
+}
+
+
+std::size_t
+SidecarReader::num_samples() const
+{
+    return header->num_samples;
+}
+
+
+std::string
+SidecarReader::hostname() const
+{
+    return std::string( header->hostname, strnlen( header->hostname, sizeof( header->hostname ) ) );
+}
+
+
+std::string
+SidecarReader::unit( std::size_t metric ) const
+{
+    const auto& entry = reinterpret_cast<const SidecarFormat::MetricEntry*>( memory + header->metrics_offset )[ metric ];
+    return std::string( entry.unit, strnlen( entry.unit, sizeof( entry.unit ) ) );
+}
+
+
+long
+SidecarReader::find_metric( const std::string& name ) const
+{
+    const auto it = std::find( names.begin(), names.end(), name );
+    return it == names.end() ? -1 : it - names.begin();
+}
+
+
+Span<std::uint64_t>
+SidecarReader::timestamps() const
+{
+    return { reinterpret_cast<const std::uint64_t*>( memory + header->timestamps_offset ), header->num_samples };
+}
+
+
+Span<double>
+SidecarReader::values( std::size_t metric ) const
+{
+    return { reinterpret_cast<const double*>( memory + header->values_offset + metric * header->column_stride ),
+             header->num_samples };
+}
+
+
+double
+SidecarReader::to_realtime_seconds( std::uint64_t ticks ) const
+{
+    const double tick_span = double( header->calibration_ticks[ 1 ] ) - double( header->calibration_ticks[ 0 ] );
+    const double ns_span   = double( header->calibration_realtime_ns[ 1 ] ) - double( header->calibration_realtime_ns[ 0 ] );
+    // Without a usable calibration, assume nanosecond ticks
+    const double ns_per_tick = tick_span > 0 && ns_span > 0 ? ns_span / tick_span : 1.;
+    return ( header->calibration_realtime_ns[ 0 ]
+             + ( double( ticks ) - double( header->calibration_ticks[ 0 ] ) ) * ns_per_tick ) * 1e-9;
+}
+
+
+std::vector<IntervalStats>
+interval_stats( const SidecarReader& reader, std::size_t metric, double window_s )
+{
+    std::vector<IntervalStats> stats;
+    const auto                 timestamps = reader.timestamps();
+    const auto                 values     = reader.values( metric );
+    if ( timestamps.size == 0 || window_s <= 0 )
+    {
+        return stats;
+    }
+    const bool   is_energy = reader.unit( metric ) == "J";
+    const double t0        = reader.to_realtime_seconds( timestamps[ 0 ] );
+    double       prev_t    = 0.;
+    // Energy and seconds of the samples with a known duration, per window
+    std::vector<std::pair<double, double> > covered;
+    for ( std::size_t i = 0; i < timestamps.size; ++i )
+    {
+        const double t = reader.to_realtime_seconds( timestamps[ i ] ) - t0;
+        // Timestamps before the first one, or a broken calibration, have no window
+        if ( !std::isfinite( t ) || t < 0. )
+        {
+            continue;
+        }
+        const std::size_t window = std::size_t( t / window_s );
+        while ( stats.size() <= window )
+        {
+            const double begin = stats.size() * window_s;
+            if ( is_energy )
+            {
+                stats.push_back( { begin, begin + window_s, 0., 0., 0., NAN, NAN, 0 } );
+            }
+            else
+            {
+                stats.push_back( { begin, begin + window_s, NAN, NAN, NAN, 0., -INFINITY, 0 } );
+            }
+            covered.emplace_back( 0., 0. );
+        }
+        const double dt = t - prev_t;
+        prev_t          = t;
+        if ( std::isnan( values[ i ] ) )
+        {
+            continue;
+        }
+        auto& s = stats[ window ];
+        s.samples += 1;
+        if ( !is_energy )
+        {
+            s.mean_value += values[ i ];
+            s.peak_value  = std::max( s.peak_value, values[ i ] );
+            continue;
+        }
+        s.energy_j += values[ i ];
+        // The first sample has no known duration, it only contributes energy
+        if ( i > 0 && dt > 0 )
+        {
+            covered[ window ].first  += values[ i ];
+            covered[ window ].second += dt;
+            s.peak_power_w            = std::max( s.peak_power_w, values[ i ] / dt );
+        }
+    }
+    for ( std::size_t window = 0; window < stats.size(); ++window )
+    {
+        auto& s = stats[ window ];
+        if ( is_energy )
+        {
+            // Over the time the samples cover, which is shorter than the window for the last one
+            s.mean_power_w = covered[ window ].second > 0. ? covered[ window ].first / covered[ window ].second : NAN;
+        }
+        else
+        {
+            s.mean_value = s.samples > 0 ? s.mean_value / s.samples : NAN;
+            s.peak_value = s.samples > 0 ? s.peak_value : NAN;
+        }
+    }
+    return stats;
+}
+
+
+std::vector<std::vector<IntervalStats> >
+interval_stats( const SidecarReader& reader, double window_s, unsigned int num_threads )
+{
+    std::vector<std::vector<IntervalStats> > stats( reader.num_metrics() );
+    num_threads = std::max( 1u, std::min<unsigned int>( num_threads, reader.num_metrics() ) );
+
+    std::vector<std::thread> threads;
+    for ( unsigned int thread = 0; thread < num_threads; ++thread )
+    {
+        threads.emplace_back( [ &, thread ](){
+                for ( std::size_t metric = thread; metric < stats.size(); metric += num_threads )
+                {
+                    stats[ metric ] = interval_stats( reader, metric, window_s );
+                }
+            } );
+    }
+    for ( auto& thread : threads )
+    {
+        thread.join();
+    }
+    return stats;
+}
+}
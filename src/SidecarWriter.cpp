@@ -0,0 +1,94 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "SidecarWriter.h"
+#include "meric_sidecar.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+
+namespace MericPlugin
+{
+static std::uint64_t
+align_up( std::uint64_t offset )
+{
+    return ( offset + 63 ) & ~std::uint64_t( 63 );
+}
+
+
+static void
+pad_to( std::ofstream& out, std::uint64_t offset )
+{
+    static const char zeros[ 64 ] = { 0 };
+    const auto        pos         = static_cast<std::uint64_t>( out.tellp() );
+    out.write( zeros, offset - pos );
+}
+
+
+void
+write_sidecar( const std::string& path, const std::string& hostname, const MeasurementThread& measurement )
+{
+    const SampleTable& table       = measurement.samples();
+    const auto&        metrics     = measurement.metrics();
+    const std::size_t  num_samples = table.size();
+
+    SidecarFormat::Header header;
+    std::memset( &header, 0, sizeof( header ) );
+    std::memcpy( header.magic, SidecarFormat::magic, sizeof( header.magic ) );
+    header.version           = SidecarFormat::version;
+    header.num_metrics       = metrics.size();
+    header.num_samples       = num_samples;
+    header.metrics_offset    = align_up( sizeof( header ) );
+    header.timestamps_offset = align_up( header.metrics_offset + metrics.size() * sizeof( SidecarFormat::MetricEntry ) );
+    header.values_offset     = align_up( header.timestamps_offset + num_samples * sizeof( std::uint64_t ) );
+    header.column_stride     = align_up( num_samples * sizeof( double ) );
+    header.calibration_ticks[ 0 ]       = measurement.start_clock().ticks.count();
+    header.calibration_ticks[ 1 ]       = measurement.stop_clock().ticks.count();
+    header.calibration_realtime_ns[ 0 ] = measurement.start_clock().realtime_ns;
+    header.calibration_realtime_ns[ 1 ] = measurement.stop_clock().realtime_ns;
+    std::strncpy( header.hostname, hostname.c_str(), sizeof( header.hostname ) - 1 );
+
+    std::ofstream out( path, std::ios::binary | std::ios::trunc );
+    if ( !out )
+    {
+        throw std::runtime_error( "Could not open '" + path + "' for writing" );
+    }
+    out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+    pad_to( out, header.metrics_offset );
+    for ( const Metric* metric : metrics )
+    {
+        SidecarFormat::MetricEntry entry;
+        std::memset( &entry, 0, sizeof( entry ) );
+        std::strncpy( entry.name, metric->name().c_str(), sizeof( entry.name ) - 1 );
+        std::strncpy( entry.unit, metric->unit().c_str(), sizeof( entry.unit ) - 1 );
+        out.write( reinterpret_cast<const char*>( &entry ), sizeof( entry ) );
+    }
+
+    pad_to( out, header.timestamps_offset );
+    std::vector<std::uint64_t> timestamps( num_samples );
+    for ( std::size_t row = 0; row < num_samples; ++row )
+    {
+        timestamps[ row ] = table.timestamp( row ).count();
+    }
+    out.write( reinterpret_cast<const char*>( timestamps.data() ), num_samples * sizeof( std::uint64_t ) );
+
+    std::vector<double> column( num_samples );
+    for ( std::size_t metric = 0; metric < metrics.size(); ++metric )
+    {
+        pad_to( out, header.values_offset + metric * header.column_stride );
+        table.copy_column( metric, column.data() );
+        out.write( reinterpret_cast<const char*>( column.data() ), num_samples * sizeof( double ) );
+    }
+    if ( !out )
+    {
+        throw std::runtime_error( "Could not write '" + path + "'" );
+    }
+}
+}
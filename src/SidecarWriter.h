@@ -0,0 +1,21 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include "MeasurementThread.h"
+
+#include <string>
+
+
+namespace MericPlugin
+{
+// Write all samples of a stopped measurement to a side-car file, see meric_sidecar.h
+void
+write_sidecar( const std::string&       path,
+               const std::string&       hostname,
+               const MeasurementThread& measurement );
+}
@@ -0,0 +1,230 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "SimBackend.h"
+#include "utils.h"
+
+#include <scorep/plugin/log.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+using scorep::plugin::logging;
+
+namespace MericPlugin
+{
+static const double pi = 3.14159265358979323846;
+
+
+// splitmix64, to derive reproducible per-counter parameters from the seed
+static std::uint64_t
+mix( std::uint64_t x )
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x  = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+    x  = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebULL;
+    return x ^ ( x >> 31 );
+}
+
+
+static double
+unit_interval( std::uint64_t x )
+{
+    return ( mix( x ) >> 11 ) * ( 1. / 9007199254740992. );
+}
+
+
+SimBackend::Config
+SimBackend::config_from_options()
+{
+    Config config;
+    for ( const std::string& item : split_string( get_option( "SIM_DOMAINS", "RAPL:2" ), ',' ) )
+    {
+        const auto colon = item.find( ':' );
+        config.domains.emplace_back( item.substr( 0, colon ),
+                                     colon == item.npos ? 1 : std::stoul( item.substr( colon + 1 ) ) );
+    }
+    config.power_w = std::stod( get_option( "SIM_POWER_W", "50" ) );
+    const std::string profile = get_option( "SIM_PROFILE", "constant" );
+    if ( profile == "sine" )
+    {
+        config.profile = Profile::sine;
+    }
+    else if ( profile == "square" )
+    {
+        config.profile = Profile::square;
+    }
+    else if ( profile != "constant" )
+    {
+        throw std::invalid_argument( "Unknown simulated power profile '" + profile + "'. Expected constant, sine or square" );
+    }
+    config.period       = parse_duration( get_option( "SIM_PERIOD", "1s" ) );
+    config.refresh      = parse_duration( get_option( "SIM_REFRESH", "1ms" ) );
+    config.read_latency = parse_duration( get_option( "SIM_READ_LATENCY", "0" ) );
+    config.wrap_j       = std::stod( get_option( "SIM_WRAP_J", "0" ) );
+    config.seed         = std::stoull( get_option( "SIM_SEED", "0" ) );
+    return config;
+}
+
+
+SimBackend::SimBackend( const std::vector<unsigned int>& requested_domains, Config config ) :
+    config( std::move( config ) ),
+    start( this->config.clock() )
+{
+    for ( const auto& item : this->config.domains )
+    {
+        const auto id_it = domain_id_by_name.find( item.first );
+        if ( id_it == domain_id_by_name.end() )
+        {
+            logging::warn() << "Unknown simulated domain '" << item.first << "'";
+            continue;
+        }
+        const unsigned int id = id_it->second;
+        if ( std::find( requested_domains.begin(), requested_domains.end(), id ) == requested_domains.end() )
+        {
+            continue;
+        }
+        Domain& domain = domains[ item.first ];
+        domain.id  = id;
+        domain.idx = id;
+        for ( unsigned int i = 0; i < item.second; ++i )
+        {
+            const unsigned int  counter_idx = domain.counter_idx_by_name.size();
+            const std::uint64_t key         = this->config.seed * 1000003 + id * 65537 + counter_idx;
+            domain.counter_idx_by_name.emplace( "COUNTER_" + std::to_string( counter_idx ), counter_idx );
+            counters.push_back( {
+                .domain_id   = id,
+                .counter_idx = counter_idx,
+                .scale       = 0.5 + unit_interval( key ),
+                .phase       = unit_interval( key ^ 0x5bd1e995 ),
+                .last_raw    = 0.,
+                .accumulated = 0.
+            } );
+        }
+    }
+}
+
+
+std::unordered_map<std::string, Domain>
+SimBackend::query_enabled_domains()
+{
+    return domains;
+}
+
+
+double
+SimBackend::energy( unsigned int domain_id, unsigned int counter_idx, double seconds ) const
+{
+    for ( const auto& counter : counters )
+    {
+        if ( counter.domain_id == domain_id && counter.counter_idx == counter_idx )
+        {
+            return counter_energy( counter, seconds );
+        }
+    }
+    return 0.;
+}
+
+
+double
+SimBackend::counter_energy( const Counter& counter, double seconds ) const
+{
+    const double power  = config.power_w * counter.scale;
+    const double period = std::chrono::duration<double>( config.period ).count();
+    switch ( config.profile )
+    {
+        case Profile::sine:
+        {
+            // P(t) = power * (1 + 0.5 * sin(2 pi (t / period + phase)))
+            const double w = 2 * pi / period;
+            return power * ( seconds - 0.5 / w * ( std::cos( w * seconds + 2 * pi * counter.phase )
+                                                   - std::cos( 2 * pi * counter.phase ) ) );
+        }
+        case Profile::square:
+        {
+            // 1.5 * power during the first half of each period, 0.5 * power during the second
+            auto integral = []( double u ){
+                                const double f = u - std::floor( u );
+                                return std::floor( u ) + ( f < 0.5 ? 1.5 * f : 0.75 + 0.5 * ( f - 0.5 ) );
+                            };
+            return power * period * ( integral( seconds / period + counter.phase ) - integral( counter.phase ) );
+        }
+        case Profile::constant:
+        default:
+            return power * seconds;
+    }
+}
+
+
+double
+SimBackend::raw_value( const Counter& counter, double seconds ) const
+{
+    if ( config.refresh.count() > 0 )
+    {
+        const double refresh = std::chrono::duration<double>( config.refresh ).count();
+        seconds = std::floor( seconds / refresh ) * refresh;
+    }
+    const double value = counter_energy( counter, seconds );
+    return config.wrap_j > 0. ? std::fmod( value, config.wrap_j ) : value;
+}
+
+
+std::chrono::microseconds
+SimBackend::max_safe_interval() const
+{
+    // The counter scale and the profile each raise the power by at most 1.5
+    const double max_power = 2.25 * config.power_w;
+    if ( config.wrap_j <= 0. || max_power <= 0. )
+    {
+        return std::chrono::microseconds( 0 );
+    }
+    return std::chrono::microseconds( std::int64_t( config.wrap_j / max_power * 1e6 ) );
+}
+
+
+void
+SimBackend::read( EnergyReading& reading )
+{
+    const auto now = config.clock();
+    if ( config.read_latency.count() > 0 )
+    {
+        // Busy wait, like a sensor read would keep the sampler busy
+        const auto begin = std::chrono::steady_clock::now();
+        while ( std::chrono::steady_clock::now() < begin + config.read_latency )
+        {
+        }
+    }
+    const double seconds = std::chrono::duration<double>( now - start ).count();
+
+    reading.domain_data.resize( EXTLIB_NUM_DOMAINS );
+    for ( const auto& item : domains )
+    {
+        auto& domain = reading.domain_data[ item.second.idx ];
+        domain.energy_per_counter.resize( item.second.counter_idx_by_name.size() );
+        domain.energy_total = 0.;
+    }
+    reading.energy_total = 0.;
+
+    for ( auto& counter : counters )
+    {
+        const double raw   = raw_value( counter, seconds );
+        double       delta = raw - counter.last_raw;
+        if ( delta < 0. )
+        {
+            delta += config.wrap_j;
+        }
+        counter.last_raw     = raw;
+        counter.accumulated += delta;
+
+        auto& domain = reading.domain_data[ counter.domain_id ];
+        domain.energy_per_counter[ counter.counter_idx ] = counter.accumulated;
+        domain.energy_total                             += counter.accumulated;
+        reading.energy_total                            += counter.accumulated;
+    }
+}
+}
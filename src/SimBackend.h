@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include "EnergyBackend.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace MericPlugin
+{
+/*
+ * Energy backend with synthetic, deterministic counters, for testing without hardware.
+ *
+ * Each counter draws a power of `power_w` scaled by a fixed per-counter factor in
+ * [0.5, 1.5), following the chosen profile. The counter value only changes every
+ * `refresh`, and wraps around at `wrap_j` if that is not zero. The time of the
+ * counters comes from `clock`, which tests can replace to control it.
+ */
+class SimBackend : public EnergyBackend
+{
+public:
+    enum class Profile
+    {
+        constant,
+        sine,
+        square
+    };
+
+    struct Config
+    {
+        // Number of counters per domain name, e.g. { "RAPL", 4 }
+        std::vector<std::pair<std::string, unsigned int> > domains;
+        double                                             power_w      = 50.;
+        Profile                                            profile      = Profile::constant;
+        std::chrono::microseconds                          period       = std::chrono::seconds( 1 );
+        std::chrono::microseconds                          refresh      = std::chrono::milliseconds( 1 );
+        std::chrono::microseconds                          read_latency = std::chrono::microseconds( 0 );
+        double                                             wrap_j       = 0.;
+        std::uint64_t                                      seed         = 0;
+        std::chrono::steady_clock::time_point              ( *clock )() = &std::chrono::steady_clock::now;
+    };
+
+    // Read the configuration from the SIM_* options, see README.md
+    static Config
+    config_from_options();
+
+    SimBackend( const std::vector<unsigned int>& requested_domains,
+                Config                           config );
+
+    std::unordered_map<std::string, Domain>
+    query_enabled_domains() override;
+
+    void
+    read( EnergyReading& reading ) override;
+
+    std::chrono::microseconds
+    max_safe_interval() const override;
+
+    // Energy of a counter after `seconds`, without refresh granularity and wraparound
+    double
+    energy( unsigned int domain_id,
+            unsigned int counter_idx,
+            double       seconds ) const;
+
+private:
+    struct Counter
+    {
+        unsigned int domain_id;
+        unsigned int counter_idx;
+        double       scale;
+        double       phase;
+        double       last_raw;
+        double       accumulated;
+    };
+
+    double
+    counter_energy( const Counter& counter,
+                    double         seconds ) const;
+
+    double
+    raw_value( const Counter& counter,
+               double         seconds ) const;
+
+    Config                                  config;
+    std::chrono::steady_clock::time_point   start;
+    std::unordered_map<std::string, Domain> domains;
+    std::vector<Counter>                    counters;
+};
+}
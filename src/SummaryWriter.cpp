@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "SummaryWriter.h"
+#include "utils.h"
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace MericPlugin
+{
+// JSON has no representation for infinity, metrics without any power value get null
+static std::string
+number( double value )
+{
+    if ( !std::isfinite( value ) )
+    {
+        return "null";
+    }
+    std::ostringstream ss;
+    ss.precision( std::numeric_limits<double>::max_digits10 );
+    ss << value;
+    return ss.str();
+}
+
+
+void
+write_summary( const std::string& path, const std::string& hostname, const MeasurementThread& measurement, SummaryFormat format )
+{
+    std::ofstream out( path, std::ios::trunc );
+    if ( !out )
+    {
+        throw std::runtime_error( "Could not open '" + path + "' for writing" );
+    }
+
+    const auto&  metrics  = measurement.metrics();
+    const auto&  stats    = measurement.stats();
+    const double duration = measurement.sampled_seconds();
+    const auto   samples  = measurement.samples_taken();
+    const auto   missed   = measurement.missed_ticks();
+
+    if ( format == SummaryFormat::csv )
+    {
+        out << "host,metric,unit,samples,missed_ticks,duration_s,energy_j,mean_power_w,min_power_w,peak_power_w\n";
+    }
+    else
+    {
+        out << "{ \"host\": " << json_quote( hostname ) << ", \"samples\": " << samples << ", \"missed_ticks\": " << missed
+            << ", \"duration_s\": " << number( duration ) << ", \"metrics\": [\n";
+    }
+
+    bool first = true;
+    for ( std::size_t column = 0; column < metrics.size(); ++column )
+    {
+        if ( !metrics[ column ]->isEnergy() )
+        {
+            continue;
+        }
+        const auto&  metric     = *metrics[ column ];
+        const double mean_power = duration > 0. ? stats[ column ].energy / duration : NAN;
+        if ( format == SummaryFormat::csv )
+        {
+            out << hostname << "," << metric.name() << "," << metric.unit() << "," << samples << "," << missed << ","
+                << number( duration ) << "," << number( stats[ column ].energy ) << "," << number( mean_power ) << ","
+                << number( stats[ column ].min_power ) << "," << number( stats[ column ].peak_power ) << "\n";
+        }
+        else
+        {
+            out << ( first ? "" : ",\n" )
+                << "  { \"metric\": " << json_quote( metric.name() ) << ", \"unit\": " << json_quote( metric.unit() )
+                << ", \"energy_j\": " << number( stats[ column ].energy )
+                << ", \"mean_power_w\": " << number( mean_power )
+                << ", \"min_power_w\": " << number( stats[ column ].min_power )
+                << ", \"peak_power_w\": " << number( stats[ column ].peak_power ) << " }";
+        }
+        first = false;
+    }
+    if ( format == SummaryFormat::json )
+    {
+        out << "\n] }\n";
+    }
+    if ( !out )
+    {
+        throw std::runtime_error( "Could not write '" + path + "'" );
+    }
+}
+
+
+void
+write_histograms( const std::string& path, const MeasurementThread& measurement )
+{
+    std::ofstream out( path, std::ios::trunc );
+    if ( !out )
+    {
+        throw std::runtime_error( "Could not open '" + path + "' for writing" );
+    }
+    out << "metric,lower_w,upper_w,seconds\n";
+    const auto& metrics    = measurement.metrics();
+    const auto& histograms = measurement.histograms();
+    for ( std::size_t column = 0; column < histograms.size(); ++column )
+    {
+        if ( !metrics[ column ]->isEnergy() )
+        {
+            continue;
+        }
+        for ( std::size_t bucket = 0; bucket < PowerHistogram::num_buckets; ++bucket )
+        {
+            if ( histograms[ column ].bucket_seconds( bucket ) > 0. )
+            {
+                const double upper = PowerHistogram::upper_bound( bucket );
+                out << metrics[ column ]->name() << "," << number( PowerHistogram::lower_bound( bucket ) ) << ","
+                    << ( std::isinf( upper ) ? "inf" : number( upper ) ) << ","
+                    << number( histograms[ column ].bucket_seconds( bucket ) ) << "\n";
+            }
+        }
+    }
+    if ( !out )
+    {
+        throw std::runtime_error( "Could not write '" + path + "'" );
+    }
+}
+}
@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include "MeasurementThread.h"
+
+#include <string>
+
+
+namespace MericPlugin
+{
+enum class SummaryFormat
+{
+    json,
+    csv
+};
+
+/*
+ * Write the energy statistics of a stopped measurement: energy, mean, minimum and peak
+ * power per metric, and the number of samples and missed ticks of the host.
+ * The JSON format has one metric object per line, the CSV format one row per metric.
+ * meric_summary combines the files of all hosts of a job.
+ */
+void
+write_summary( const std::string&       path,
+               const std::string&       hostname,
+               const MeasurementThread& measurement,
+               SummaryFormat            format );
+
+
+/*
+ * Write the non-empty buckets of the power histograms of a stopped measurement as CSV,
+ * one row per bucket with its power bounds and the time spent in it.
+ */
+void
+write_histograms( const std::string&       path,
+                  const MeasurementThread& measurement );
+}
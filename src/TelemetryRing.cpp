@@ -0,0 +1,260 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "TelemetryRing.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+
+
+namespace MericPlugin
+{
+namespace TelemetryRing
+{
+static std::size_t
+align_up( std::size_t size )
+{
+    return ( size + 63 ) & ~std::size_t( 63 );
+}
+
+
+static std::size_t
+names_offset()
+{
+    return align_up( sizeof( Header ) );
+}
+
+
+static std::size_t
+units_offset( std::uint32_t num_metrics )
+{
+    return names_offset() + align_up( num_metrics * metric_name_size );
+}
+
+
+static std::size_t
+slots_offset( std::uint32_t num_metrics )
+{
+    return units_offset( num_metrics ) + align_up( num_metrics * metric_unit_size );
+}
+
+
+std::size_t
+slot_size( std::uint32_t num_metrics )
+{
+    return align_up( sizeof( Slot ) + num_metrics * sizeof( double ) );
+}
+
+
+std::size_t
+total_size( std::uint32_t num_metrics, std::uint64_t num_slots )
+{
+    return slots_offset( num_metrics ) + num_slots * slot_size( num_metrics );
+}
+
+
+std::uint64_t
+monotonic_ns()
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return std::uint64_t( ts.tv_sec ) * 1000000000ULL + ts.tv_nsec;
+}
+
+
+static std::runtime_error
+system_error( const std::string& what, const std::string& name )
+{
+    return std::runtime_error( what + " '" + name + "': " + std::strerror( errno ) );
+}
+}
+
+
+using namespace TelemetryRing;
+
+
+TelemetryRingWriter::TelemetryRingWriter( std::string name, const std::vector<std::string>& metric_names, const std::vector<std::string>& metric_units, std::uint64_t num_slots, std::uint64_t interval_us ) :
+    name( std::move( name ) ),
+    size( total_size( metric_names.size(), num_slots ) )
+{
+    if ( num_slots == 0 )
+    {
+        throw std::invalid_argument( "Shared-memory ring needs at least one slot" );
+    }
+    if ( metric_units.size() != metric_names.size() )
+    {
+        throw std::invalid_argument( "Shared-memory ring needs a unit for every metric" );
+    }
+    int fd = shm_open( this->name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644 );
+    if ( fd < 0 )
+    {
+        throw system_error( "Could not create shared memory", this->name );
+    }
+    if ( ftruncate( fd, size ) != 0 )
+    {
+        close( fd );
+        shm_unlink( this->name.c_str() );
+        throw system_error( "Could not resize shared memory", this->name );
+    }
+    void* addr = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( addr == MAP_FAILED )
+    {
+        shm_unlink( this->name.c_str() );
+        throw system_error( "Could not map shared memory", this->name );
+    }
+    memory = static_cast<unsigned char*>( addr );
+
+    header              = new( memory ) Header;
+    header->version     = TelemetryRing::version;
+    header->num_metrics = metric_names.size();
+    header->num_slots   = num_slots;
+    header->interval_us = interval_us;
+    header->writer_pid  = getpid();
+    header->write_index.store( 0, std::memory_order_relaxed );
+
+    char* names = reinterpret_cast<char*>( memory + names_offset() );
+    char* units = reinterpret_cast<char*>( memory + units_offset( header->num_metrics ) );
+    for ( std::size_t i = 0; i < metric_names.size(); ++i )
+    {
+        std::strncpy( names + i * metric_name_size, metric_names[ i ].c_str(), metric_name_size - 1 );
+        std::strncpy( units + i * metric_unit_size, metric_units[ i ].c_str(), metric_unit_size - 1 );
+    }
+    for ( std::uint64_t i = 0; i < num_slots; ++i )
+    {
+        Slot* slot = new( memory + slots_offset( header->num_metrics ) + i * slot_size( header->num_metrics ) ) Slot;
+        slot->sequence.store( 0, std::memory_order_relaxed );
+    }
+    // Publish the magic last, readers ignore the ring until it is set
+    header->magic.store( TelemetryRing::magic, std::memory_order_release );
+}
+
+
+TelemetryRingWriter::~TelemetryRingWriter()
+{
+    munmap( memory, size );
+    shm_unlink( name.c_str() );
+}
+
+
+void
+TelemetryRingWriter::publish( std::uint64_t timestamp_ns, std::uint64_t duration_ns, const double* values )
+{
+    const std::uint32_t num_metrics = header->num_metrics;
+    const std::uint64_t index       = next_index++;
+    unsigned char*      base        = memory + slots_offset( num_metrics ) + ( index % header->num_slots ) * slot_size( num_metrics );
+    Slot*               slot        = reinterpret_cast<Slot*>( base );
+
+    slot->sequence.store( 2 * index + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+    slot->timestamp_ns = timestamp_ns;
+    slot->duration_ns  = duration_ns;
+    std::memcpy( base + sizeof( Slot ), values, num_metrics * sizeof( double ) );
+    slot->sequence.store( 2 * index + 2, std::memory_order_release );
+    header->write_index.store( index + 1, std::memory_order_release );
+}
+
+
+TelemetryRingReader::TelemetryRingReader( std::string name ) :
+    name( std::move( name ) )
+{
+    int fd = shm_open( this->name.c_str(), O_RDONLY, 0 );
+    if ( fd < 0 )
+    {
+        throw system_error( "Could not open shared memory", this->name );
+    }
+    struct stat st;
+    if ( fstat( fd, &st ) != 0 || std::size_t( st.st_size ) < sizeof( Header ) )
+    {
+        close( fd );
+        throw std::runtime_error( "Shared memory '" + this->name + "' is not a telemetry ring" );
+    }
+    size = st.st_size;
+    void* addr = mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( addr == MAP_FAILED )
+    {
+        throw system_error( "Could not map shared memory", this->name );
+    }
+    memory = static_cast<const unsigned char*>( addr );
+    header = reinterpret_cast<const Header*>( memory );
+
+    if ( header->magic.load( std::memory_order_acquire ) != TelemetryRing::magic
+         || header->version != TelemetryRing::version
+         || size < total_size( header->num_metrics, header->num_slots ) )
+    {
+        munmap( const_cast<unsigned char*>( memory ), size );
+        throw std::runtime_error( "Shared memory '" + this->name + "' is not a compatible telemetry ring" );
+    }
+
+    const char* raw_names = reinterpret_cast<const char*>( memory + names_offset() );
+    const char* raw_units = reinterpret_cast<const char*>( memory + units_offset( header->num_metrics ) );
+    for ( std::uint32_t i = 0; i < header->num_metrics; ++i )
+    {
+        const char* name_begin = raw_names + i * metric_name_size;
+        const char* unit_begin = raw_units + i * metric_unit_size;
+        names.emplace_back( name_begin, strnlen( name_begin, metric_name_size ) );
+        units.emplace_back( unit_begin, strnlen( unit_begin, metric_unit_size ) );
+    }
+}
+
+
+TelemetryRingReader::~TelemetryRingReader()
+{
+    munmap( const_cast<unsigned char*>( memory ), size );
+}
+
+
+std::uint64_t
+TelemetryRingReader::num_slots() const
+{
+    return header->num_slots;
+}
+
+
+std::uint64_t
+TelemetryRingReader::interval_us() const
+{
+    return header->interval_us;
+}
+
+
+std::uint64_t
+TelemetryRingReader::write_index() const
+{
+    return header->write_index.load( std::memory_order_acquire );
+}
+
+
+bool
+TelemetryRingReader::read( std::uint64_t index, Sample& sample ) const
+{
+    const std::uint32_t  num_metrics = header->num_metrics;
+    const unsigned char* base        = memory + slots_offset( num_metrics ) + ( index % header->num_slots ) * slot_size( num_metrics );
+    const Slot*          slot        = reinterpret_cast<const Slot*>( base );
+
+    const std::uint64_t expected = 2 * index + 2;
+    if ( slot->sequence.load( std::memory_order_acquire ) != expected )
+    {
+        return false;
+    }
+    sample.index        = index;
+    sample.timestamp_ns = slot->timestamp_ns;
+    sample.duration_ns  = slot->duration_ns;
+    sample.values.resize( num_metrics );
+    std::memcpy( sample.values.data(), base + sizeof( Slot ), num_metrics * sizeof( double ) );
+    std::atomic_thread_fence( std::memory_order_acquire );
+    return slot->sequence.load( std::memory_order_relaxed ) == expected;
+}
+}
@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace MericPlugin
+{
+/*
+ * Live telemetry in a named POSIX shared-memory ring.
+ *
+ * Layout of the shared memory object:
+ *
+ *     Header
+ *     char[metric_name_size] * num_metrics    metric names
+ *     char[metric_unit_size] * num_metrics    metric units, e.g. "J" or "s"
+ *     Slot * num_slots                        each followed by num_metrics doubles
+ *
+ * There is a single writer. Each slot carries a sequence number, which is odd while the
+ * slot is written and 2 * (index + 1) afterwards, so that readers can detect torn or
+ * overwritten slots without ever blocking the writer.
+ * Timestamps are CLOCK_MONOTONIC nanoseconds. Values in J are the energy consumed during
+ * the `duration_ns` before the timestamp, other values are per sample in their unit.
+ */
+namespace TelemetryRing
+{
+constexpr std::uint64_t magic            = 0x474e52434952454dULL; // "MERICRNG";
+constexpr std::uint32_t version          = 2;
+constexpr std::size_t   metric_name_size = 64;
+constexpr std::size_t   metric_unit_size = 16;
+
+static_assert( ATOMIC_LLONG_LOCK_FREE == 2, "Shared-memory ring needs lock-free 64-bit atomics" );
+
+struct Header
+{
+    std::atomic<std::uint64_t> magic;
+    std::uint32_t              version;
+    std::uint32_t              num_metrics;
+    std::uint64_t              num_slots;
+    std::uint64_t              interval_us;
+    std::uint64_t              writer_pid;
+    std::atomic<std::uint64_t> write_index; // Number of slots written so far
+};
+
+struct Slot
+{
+    std::atomic<std::uint64_t> sequence;
+    std::uint64_t              timestamp_ns;
+    std::uint64_t              duration_ns;
+};
+
+struct Sample
+{
+    std::uint64_t       index;
+    std::uint64_t       timestamp_ns;
+    std::uint64_t       duration_ns;
+    std::vector<double> values;
+};
+
+std::size_t
+slot_size( std::uint32_t num_metrics );
+
+std::size_t
+total_size( std::uint32_t num_metrics,
+            std::uint64_t num_slots );
+
+std::uint64_t
+monotonic_ns();
+}
+
+
+class TelemetryRingWriter
+{
+public:
+    TelemetryRingWriter( std::string                     name,
+                         const std::vector<std::string>& metric_names,
+                         const std::vector<std::string>& metric_units,
+                         std::uint64_t                   num_slots,
+                         std::uint64_t                   interval_us );
+
+    ~TelemetryRingWriter();
+
+    TelemetryRingWriter( const TelemetryRingWriter& ) = delete;
+    TelemetryRingWriter&
+    operator=( const TelemetryRingWriter& ) = delete;
+
+    void
+    publish( std::uint64_t timestamp_ns,
+             std::uint64_t duration_ns,
+             const double* values );
+
+private:
+    std::string            name;
+    std::size_t            size;
+    unsigned char*         memory;
+    TelemetryRing::Header* header;
+    std::uint64_t          next_index = 0;
+};
+
+
+class TelemetryRingReader
+{
+public:
+    TelemetryRingReader( std::string name );
+
+    ~TelemetryRingReader();
+
+    TelemetryRingReader( const TelemetryRingReader& ) = delete;
+    TelemetryRingReader&
+    operator=( const TelemetryRingReader& ) = delete;
+
+    const std::vector<std::string>&
+    metric_names() const
+    {
+        return names;
+    }
+
+    const std::vector<std::string>&
+    metric_units() const
+    {
+        return units;
+    }
+
+    std::uint64_t
+    num_slots() const;
+
+    std::uint64_t
+    interval_us() const;
+
+    // Number of slots written so far. The most recent sample has index write_index() - 1.
+    std::uint64_t
+    write_index() const;
+
+    // Copy the sample with the given index. Returns false if the slot has not been
+    // written yet, has already been overwritten, or was modified while copying.
+    bool
+    read( std::uint64_t           index,
+          TelemetryRing::Sample& sample ) const;
+
+private:
+    std::string                  name;
+    std::size_t                  size;
+    const unsigned char*         memory;
+    const TelemetryRing::Header* header;
+    std::vector<std::string>     names;
+    std::vector<std::string>     units;
+};
+}
@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "Watchdog.h"
+
+#include <scorep/plugin/log.hpp>
+
+#include <stdexcept>
+
+
+using scorep::plugin::logging;
+
+namespace MericPlugin
+{
+WatchdogBackend::WatchdogBackend( std::unique_ptr<EnergyBackend>&& backend, std::chrono::microseconds period ) :
+    backend( std::move( backend ) ),
+    period( period ),
+    thread( [ this ](){
+            this->watch();
+        } )
+{
+}
+
+
+WatchdogBackend::~WatchdogBackend()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        active = false;
+    }
+    wakeup.notify_all();
+    thread.join();
+}
+
+
+std::unordered_map<std::string, Domain>
+WatchdogBackend::query_enabled_domains()
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return backend->query_enabled_domains();
+}
+
+
+void
+WatchdogBackend::read( EnergyReading& reading )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    backend->read( reading );
+}
+
+
+void
+WatchdogBackend::calc_energy_consumption( const EnergyReading& begin, const EnergyReading& end, EnergyReading& result ) const
+{
+    backend->calc_energy_consumption( begin, end, result );
+}
+
+
+void
+WatchdogBackend::watch()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    while ( !wakeup.wait_for( lock, period, [ this ](){
+            return !active;
+        } ) )
+    {
+        try
+        {
+            backend->read( scratch );
+        }
+        catch ( const std::runtime_error& e )
+        {
+            logging::warn() << "Watchdog read failed, stopping the watchdog: " << e.what();
+            return;
+        }
+    }
+}
+
+
+std::unique_ptr<EnergyBackend>
+guard_against_wraps( std::unique_ptr<EnergyBackend> backend, std::chrono::microseconds interval )
+{
+    const auto safe = backend->max_safe_interval();
+    if ( safe.count() == 0 || interval < safe / 2 )
+    {
+        return backend;
+    }
+    logging::info() << "Counters can wrap within " << safe.count() << " us, reading them every "
+                    << ( safe / 2 ).count() << " us in a watchdog thread";
+    return std::unique_ptr<EnergyBackend>( new WatchdogBackend( std::move( backend ), safe / 2 ) );
+}
+}
@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#pragma once
+
+#include "EnergyBackend.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+
+namespace MericPlugin
+{
+/*
+ * Reads another backend in a background thread every `period`, so that its counters
+ * accumulate every wraparound even if the sampler reads much less often. Reads of the
+ * sampler and of the watchdog are serialized with a mutex.
+ */
+class WatchdogBackend : public EnergyBackend
+{
+public:
+    WatchdogBackend( std::unique_ptr<EnergyBackend>&& backend,
+                     std::chrono::microseconds        period );
+
+    ~WatchdogBackend();
+
+    std::unordered_map<std::string, Domain>
+    query_enabled_domains() override;
+
+    void
+    read( EnergyReading& reading ) override;
+
+    void
+    calc_energy_consumption( const EnergyReading& begin,
+                             const EnergyReading& end,
+                             EnergyReading&       result ) const override;
+
+    // Any interval is safe while the watchdog runs
+    std::chrono::microseconds
+    max_safe_interval() const override
+    {
+        return std::chrono::microseconds( 0 );
+    }
+
+private:
+    void
+    watch();
+
+    std::unique_ptr<EnergyBackend> backend;
+    std::chrono::microseconds      period;
+    EnergyReading                  scratch; // Reading of the watchdog, reused
+    bool                           active = true;
+    std::mutex                     mutex;
+    std::condition_variable        wakeup;
+    std::thread                    thread;
+};
+
+
+// Wraps `backend` in a watchdog if reads every `interval` could miss a counter wraparound.
+// The watchdog reads at half the longest safe interval.
+std::unique_ptr<EnergyBackend>
+guard_against_wraps( std::unique_ptr<EnergyBackend> backend,
+                     std::chrono::microseconds      interval );
+}
@@ -6,23 +6,47 @@
  *
  */
 #include "meric_plugin.h"
+#include "meric_plugin_control.h"
+#include "DeviceFilter.h"
+#include "Recording.h"
+#include "SidecarWriter.h"
+#include "SummaryWriter.h"
+#include "Watchdog.h"
 #include "utils.h"
 
 #include <scorep/plugin/plugin.hpp>
 
+#include <unistd.h>
+
+#include <algorithm>
 #include <chrono>
+#include <climits>
+#include <iterator>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
 
 
 using scorep::plugin::logging;
 
 namespace MericPlugin
 {
+// Domains that measure the CPU packages, the only ones the CPU time of processes relates to
+static const char* const cpu_domains[] = { "A64FX", "RAPL" };
+
+
+static bool
+is_cpu_domain( const std::string& domain_name )
+{
+    return std::find( std::begin( cpu_domains ), std::end( cpu_domains ), domain_name ) != std::end( cpu_domains );
+}
+
+
 static std::string
 comma_separated_domain_list()
 {
     std::stringstream ss;
-    for ( auto item : ExtlibWrapper::domain_id_by_name )
+    for ( auto item : EnergyBackend::domain_id_by_name )
     {
         ss << item.first << ", ";
     }
@@ -42,7 +66,7 @@ meric_plugin::requested_domain_ids( std::string env_str )
     }
     if ( env_str == "ALL" )
     {
-        for ( auto item : ExtlibWrapper::domain_id_by_name )
+        for ( auto item : EnergyBackend::domain_id_by_name )
         {
             requested_ids.emplace_back( item.second );
         }
@@ -51,8 +75,8 @@ meric_plugin::requested_domain_ids( std::string env_str )
     // expecting a comma-separated list of energy domains
     for ( std::string name : split_string( env_str, ',' ) )
     {
-        const auto it = ExtlibWrapper::domain_id_by_name.find( name );
-        if ( it != ExtlibWrapper::domain_id_by_name.end() )
+        const auto it = EnergyBackend::domain_id_by_name.find( name );
+        if ( it != EnergyBackend::domain_id_by_name.end() )
         {
             requested_ids.emplace_back( it->second );
         }
@@ -65,15 +89,265 @@ meric_plugin::requested_domain_ids( std::string env_str )
 }
 
 
-meric_plugin::meric_plugin() :
-    measurement( std::chrono::microseconds( stoi( scorep::environment_variable::get( "INTERVAL_US", "50000" ) ) ) )
+std::vector<MeasurementThread::BurstWindow>
+meric_plugin::burst_schedule( std::string env_str )
 {
-    logging::info() << "Measurement interval: " << measurement.interval().count() << " microseconds";
+    // expecting a comma-separated list of windows <begin>@<interval>:<duration>, e.g. 60s@500us:5s
+    std::vector<MeasurementThread::BurstWindow> windows;
+    for ( const std::string& window : split_string( env_str, ',' ) )
+    {
+        const auto at    = window.find( '@' );
+        const auto colon = window.find( ':', at );
+        if ( at == window.npos || colon == window.npos )
+        {
+            logging::warn() << "Ignoring burst window '" << window << "' in " << scorep::environment_variable::name( "BURST" ) << ". Expected <begin>@<interval>:<duration>";
+            continue;
+        }
+        try
+        {
+            windows.push_back( {
+                .begin    = parse_duration( window.substr( 0, at ) ),
+                .interval = parse_duration( window.substr( at + 1, colon - at - 1 ) ),
+                .duration = parse_duration( window.substr( colon + 1 ) )
+            } );
+            if ( windows.back().interval.count() == 0 )
+            {
+                // The sampler would spin for the whole window, the C API rejects it as well
+                windows.pop_back();
+                throw std::invalid_argument( "The interval must be positive" );
+            }
+        }
+        catch ( const std::invalid_argument& e )
+        {
+            logging::warn() << "Ignoring burst window '" << window << "': " << e.what();
+        }
+    }
+    return windows;
+}
+
+
+std::string
+meric_plugin::output_name()
+{
+    char hostname[ 256 ] = { 0 };
+    gethostname( hostname, sizeof( hostname ) - 1 );
+#ifdef MERIC_PLUGIN_PER_PROCESS
+    return std::string( "meric_gpu_" ) + hostname + "_" + std::to_string( getpid() );
+#else
+    return std::string( "meric_" ) + hostname;
+#endif
+}
+
 
+std::unordered_map<std::string, Domain>
+meric_plugin::domains_from_metric_names( const std::vector<std::string>& names )
+{
+    // The ring of the daemon names its metrics <domain>:<counter>, like the plugin
+    std::unordered_map<std::string, Domain> domains;
+    for ( const auto& name : names )
+    {
+        const auto parts = split_string( name, ':' );
+        if ( parts.size() != 2 )
+        {
+            continue;
+        }
+        const auto id_it = EnergyBackend::domain_id_by_name.find( parts[ 0 ] );
+        if ( id_it == EnergyBackend::domain_id_by_name.end() )
+        {
+            continue; // TOTAL:TOTAL
+        }
+        auto domain_it = domains.find( parts[ 0 ] );
+        if ( domain_it == domains.end() )
+        {
+            domain_it = domains.emplace( parts[ 0 ], Domain{ .id = id_it->second, .idx = id_it->second, .counter_idx_by_name = {} } ).first;
+        }
+        if ( parts[ 1 ] != "TOTAL" )
+        {
+            auto& counters = domain_it->second.counter_idx_by_name;
+            counters.emplace( parts[ 1 ], counters.size() );
+        }
+    }
+    return domains;
+}
+
+
+std::unique_ptr<EnergyBackend>
+meric_plugin::make_energy_backend( std::chrono::microseconds interval )
+{
+#ifdef MERIC_PLUGIN_PER_PROCESS
+    std::string               env_requested_domains = scorep::environment_variable::get( "DOMAINS", "NVML,ROCM" );
+#else
     std::string               env_requested_domains = scorep::environment_variable::get( "DOMAINS", "ALL" );
+#endif
     std::vector<unsigned int> requested_domains     = requested_domain_ids( env_requested_domains );
-    this->extlib         = ExtlibWrapper( requested_domains );
-    this->domain_by_name = this->extlib.query_enabled_domains();
+    const std::string         backend_name          = scorep::environment_variable::get( "BACKEND", "extlib" );
+
+    std::unique_ptr<EnergyBackend> backend;
+    try
+    {
+        backend = make_backend( backend_name, requested_domains );
+        logging::info() << "Energy backend: " << backend_name;
+    }
+    catch ( const std::invalid_argument& e )
+    {
+        logging::warn() << e.what() << ". Using 'extlib'";
+        backend = make_backend( "extlib", requested_domains );
+    }
+#ifdef MERIC_PLUGIN_PER_PROCESS
+    // Only the devices of this process
+    auto devices = DeviceFilterBackend::devices_from_environment( scorep::environment_variable::get( "DEVICES", "" ) );
+    if ( !devices.empty() )
+    {
+        std::unique_ptr<EnergyBackend> filtered( new DeviceFilterBackend( std::move( backend ), std::move( devices ) ) );
+        backend = std::move( filtered );
+    }
+#endif
+    // Long intervals would miss counter wraparounds without the watchdog. It is placed
+    // inside the recording, so that only the reads of the sampler are recorded.
+    backend = guard_against_wraps( std::move( backend ), interval );
+
+    const std::string record_path = scorep::environment_variable::get( "RECORD", "" );
+    if ( record_path != "" )
+    {
+        try
+        {
+            std::unique_ptr<EnergyBackend> recording( new RecordingBackend( std::move( backend ), record_path ) );
+            backend = std::move( recording );
+            logging::info() << "Recording all readings to " << record_path;
+        }
+        catch ( const std::runtime_error& e )
+        {
+            logging::warn() << e.what();
+        }
+    }
+    return backend;
+}
+
+
+// The measurement of the running plugin instance, used by the burst control API
+static MeasurementThread* active_measurement = nullptr;
+static std::mutex         active_measurement_mutex;
+
+
+meric_plugin::meric_plugin() :
+    measurement( std::chrono::microseconds( stoi( scorep::environment_variable::get( "INTERVAL_US", "50000" ) ) ),
+                 burst_schedule( scorep::environment_variable::get( "BURST", "" ) ) )
+{
+    logging::info() << "Measurement interval: " << measurement.interval().count() << " microseconds";
+
+    const std::string stamp_at = scorep::environment_variable::get( "TIMESTAMP", "midpoint" );
+    if ( stamp_at == "begin" )
+    {
+        measurement.stamp_at( MeasurementThread::StampAt::begin );
+    }
+    else if ( stamp_at == "end" )
+    {
+        measurement.stamp_at( MeasurementThread::StampAt::end );
+    }
+    else if ( stamp_at != "midpoint" )
+    {
+        logging::warn() << "Unknown value '" << stamp_at << "' for " << scorep::environment_variable::name( "TIMESTAMP" ) << ". Expected begin, midpoint or end. Using midpoint";
+    }
+    const std::string stamp_clock = scorep::environment_variable::get( "TIMESTAMP_CLOCK", "scorep" );
+    if ( stamp_clock == "raw" )
+    {
+        measurement.stamp_with_raw_clock( true );
+        logging::info() << "Stamping samples with " << ( RawClock::uses_tsc() ? "the invariant TSC" : "CLOCK_MONOTONIC_RAW" );
+    }
+    else if ( stamp_clock != "scorep" )
+    {
+        logging::warn() << "Unknown value '" << stamp_clock << "' for " << scorep::environment_variable::name( "TIMESTAMP_CLOCK" ) << ". Expected raw or scorep. Using scorep";
+    }
+
+    const std::string auto_interval = scorep::environment_variable::get( "AUTO_INTERVAL", "off" );
+    if ( auto_interval == "clamp" || auto_interval == "align" )
+    {
+        try
+        {
+            measurement.auto_interval( auto_interval == "clamp" ? MeasurementThread::AutoInterval::clamp : MeasurementThread::AutoInterval::align,
+                                       parse_duration( scorep::environment_variable::get( "CALIBRATION", "500ms" ) ) );
+        }
+        catch ( const std::invalid_argument& e )
+        {
+            logging::warn() << "Invalid " << scorep::environment_variable::name( "CALIBRATION" ) << ": " << e.what() << ". Not adapting the interval";
+        }
+    }
+    else if ( auto_interval != "off" )
+    {
+        logging::warn() << "Unknown value '" << auto_interval << "' for " << scorep::environment_variable::name( "AUTO_INTERVAL" ) << ". Expected off, clamp or align";
+    }
+
+    const std::string align_phase = scorep::environment_variable::get( "ALIGN_PHASE", "0" );
+    if ( align_phase == "1" || align_phase == "true" )
+    {
+        if ( auto_interval == "align" )
+        {
+            logging::warn() << scorep::environment_variable::name( "ALIGN_PHASE" ) << " overrides the phase of " << scorep::environment_variable::name( "AUTO_INTERVAL" ) << "=align";
+        }
+        measurement.align_phase_to_realtime( true );
+        logging::info() << "Aligning samples to multiples of the interval in CLOCK_REALTIME";
+    }
+
+    const std::string storage       = scorep::environment_variable::get( "STORAGE", "samples" );
+    const bool        histogram_dir = scorep::environment_variable::get( "HISTOGRAM", "" ) != "";
+    if ( storage == "histogram" )
+    {
+        measurement.keep_histograms( true, false );
+        logging::info() << "Keeping only power histograms, no samples are recorded to the trace";
+        if ( !histogram_dir )
+        {
+            logging::warn() << "Set " << scorep::environment_variable::name( "HISTOGRAM" ) << " to a directory to write the histograms";
+        }
+    }
+    else
+    {
+        if ( storage != "samples" )
+        {
+            logging::warn() << "Unknown value '" << storage << "' for " << scorep::environment_variable::name( "STORAGE" ) << ". Expected samples or histogram";
+        }
+        measurement.keep_histograms( histogram_dir );
+    }
+
+    const auto resample_us = std::stoll( scorep::environment_variable::get( "RESAMPLE_US", "0" ) );
+    if ( resample_us > 0 )
+    {
+        measurement.resample_to( std::chrono::microseconds( resample_us ) );
+        logging::info() << "Resampling to a uniform grid of " << resample_us << " microseconds";
+    }
+
+#ifndef MERIC_PLUGIN_PER_PROCESS
+    const std::string daemon_name = scorep::environment_variable::get( "DAEMON", "" );
+    if ( daemon_name != "" )
+    {
+        try
+        {
+            std::unique_ptr<TelemetryRingReader> ring( new TelemetryRingReader( daemon_name ) );
+            this->domain_by_name = domains_from_metric_names( ring->metric_names() );
+            if ( this->domain_by_name.empty() )
+            {
+                throw std::runtime_error( "The daemon records no energy domains" );
+            }
+            measurement.attach_to( std::move( ring ) );
+            this->attached = true;
+            logging::info() << "Copying the samples of the sampling daemon '" << daemon_name << "'";
+        }
+        catch ( const std::exception& e )
+        {
+            logging::warn() << "Cannot attach to the sampling daemon '" << daemon_name << "': " << e.what() << ". Sampling in this process";
+        }
+    }
+#endif
+    if ( !this->attached )
+    {
+        this->backend        = make_energy_backend( measurement.interval() );
+        this->domain_by_name = this->backend->query_enabled_domains();
+        // Without a watchdog, later changes of the interval must stay below its threshold
+        const auto safe = this->backend->max_safe_interval();
+        if ( safe.count() > 0 )
+        {
+            measurement.limit_interval( safe / 2 );
+        }
+    }
 
 
     // Debug output
@@ -97,13 +371,24 @@ meric_plugin::get_metric_properties( const std::string& metric_name )
     logging::debug() << "Requested metric " << metric_name;
 
     std::vector<std::string> domain_and_counter = split_string( metric_name, ':' );
-    if ( domain_and_counter.size() != 2 )
+    if ( domain_and_counter.size() != 2 && ( domain_and_counter.size() != 3 || domain_and_counter[ 2 ] != "SELF" ) )
     {
-        logging::warn() << "Metric '" << metric_name << "' has the wrong format. Expected 'DOMAIN:COUNTER'";
+        logging::warn() << "Metric '" << metric_name << "' has the wrong format. Expected 'DOMAIN:COUNTER' or 'DOMAIN:COUNTER:SELF'";
         return {};
     }
     const std::string& domain_name  = domain_and_counter[ 0 ];
     const std::string& counter_name = domain_and_counter[ 1 ];
+    const bool         self         = domain_and_counter.size() == 3;
+    if ( this->attached && ( self || domain_name == "EFF" ) )
+    {
+        logging::warn() << "Metric '" << metric_name << "' is not available from the sampling daemon";
+        return {};
+    }
+    if ( self && !is_cpu_domain( domain_name ) )
+    {
+        logging::warn() << "Metric '" << metric_name << "': only the counters of the CPU domains A64FX and RAPL can be attributed with ':SELF'";
+        return {};
+    }
 
     std::vector<scorep::plugin::metric_property> metric_properties;
 
@@ -111,7 +396,7 @@ meric_plugin::get_metric_properties( const std::string& metric_name )
                             metric_properties.push_back( scorep::plugin::metric_property(
                                                              metric.name(),
                                                              metric.description(),
-                                                             "J"
+                                                             metric.unit()
                                                              ).absolute_point().value_double().decimal() );
                         };
 
@@ -122,6 +407,52 @@ meric_plugin::get_metric_properties( const std::string& metric_name )
         return metric_properties;
     }
 
+    if ( domain_name == "PLUGIN" )
+    {
+        // Health of the sampler itself
+        for ( unsigned int value = 0; value < SamplerHealth::num_values; ++value )
+        {
+            if ( counter_name == SamplerHealth::names[ value ] )
+            {
+                add_property( make_handle( metric_name, Metric::Plugin(), SamplerHealth::Value( value ) ) );
+                return metric_properties;
+            }
+        }
+        logging::warn() << "Unknown plugin metric '" << counter_name << "'. Available: read_latency, sample_lateness, missed_ticks, buffer_bytes, reconfigured";
+        return metric_properties;
+    }
+
+    if ( domain_name == "EFF" )
+    {
+        // Efficiency of the node, co-sampled with the energy
+        for ( unsigned int value = 0; value < EfficiencySample::num_values; ++value )
+        {
+            if ( counter_name == EfficiencySample::names[ value ] )
+            {
+                add_property( make_handle( metric_name, Metric::Efficiency(), value ) );
+                return metric_properties;
+            }
+        }
+        if ( counter_name.compare( 0, 8, "avg_MHz_" ) == 0 && counter_name.size() > 8
+             && counter_name.find_first_not_of( "0123456789", 8 ) == std::string::npos )
+        {
+            // A node has at most as many sockets as CPUs. Longer numbers are not parsed, they would not fit.
+            const long          num_cpus    = sysconf( _SC_NPROCESSORS_CONF );
+            const unsigned long max_sockets = num_cpus > 0 ? num_cpus : 4096;
+            const unsigned long socket      = counter_name.size() - 8 <= 9 ? std::stoul( counter_name.substr( 8 ) ) : ULONG_MAX;
+            if ( socket >= max_sockets )
+            {
+                logging::warn() << "Ignoring efficiency metric '" << counter_name << "', there are only " << max_sockets << " CPUs";
+                return metric_properties;
+            }
+            add_property( make_handle( metric_name, Metric::Efficiency(),
+                                       EfficiencySample::num_values + static_cast<unsigned int>( socket ) ) );
+            return metric_properties;
+        }
+        logging::warn() << "Unknown efficiency metric '" << counter_name << "'. Available: avg_MHz, avg_MHz_<socket>, Ginstr_per_s, IPC, J_per_Ginstr";
+        return metric_properties;
+    }
+
     const auto domain_it = this->domain_by_name.find( domain_name );
     if ( domain_it == this->domain_by_name.end() )
     {
@@ -129,10 +460,10 @@ meric_plugin::get_metric_properties( const std::string& metric_name )
         return metric_properties;
     }
 
-    const ExtlibWrapper::Domain& domain = domain_it->second;
+    const Domain& domain = domain_it->second;
     if ( counter_name == "TOTAL" )
     {
-        add_property( make_handle( metric_name, Metric::DomainTotal(), domain.idx, domain.id, domain_name ) );
+        add_property( make_handle( metric_name, Metric::DomainTotal(), domain.idx, domain.id, domain_name, self ) );
         return metric_properties;
     }
 
@@ -143,7 +474,7 @@ meric_plugin::get_metric_properties( const std::string& metric_name )
         return metric_properties;
     }
 
-    add_property( make_handle( metric_name, Metric::Single(), domain.idx, domain.id, domain_name, counter_it->second, counter_name ) );
+    add_property( make_handle( metric_name, Metric::Single(), domain.idx, domain.id, domain_name, counter_it->second, counter_name, self ) );
     return metric_properties;
 }
 
@@ -158,14 +489,218 @@ meric_plugin::add_metric( Metric& metric )
 void
 meric_plugin::start()
 {
-    measurement.start( std::move( this->extlib ), get_handles() );
+#ifdef MERIC_PLUGIN_PER_PROCESS
+    // One ring per process
+    const std::string shm_name = scorep::environment_variable::get( "SHM", "" ) != ""
+                                 ? scorep::environment_variable::get( "SHM", "" ) + "_" + std::to_string( getpid() )
+                                 : "";
+#else
+    const std::string shm_name = scorep::environment_variable::get( "SHM", "" );
+#endif
+    if ( shm_name != "" )
+    {
+        std::vector<std::string> names;
+        std::vector<std::string> units;
+        for ( const auto& handle : get_handles() )
+        {
+            names.emplace_back( handle.name() );
+            units.emplace_back( handle.unit() );
+        }
+        try
+        {
+            const auto num_slots = std::stoull( scorep::environment_variable::get( "SHM_SLOTS", "4096" ) );
+            measurement.publish_to( std::unique_ptr<TelemetryRingWriter>(
+                                        new TelemetryRingWriter( shm_name, names, units, num_slots, measurement.interval().count() ) ) );
+            logging::info() << "Publishing live telemetry to shared memory '" << shm_name << "'";
+        }
+        catch ( const std::exception& e )
+        {
+            logging::warn() << "Live telemetry disabled: " << e.what();
+        }
+    }
+
+    bool attributed = false;
+    bool efficiency = false;
+    for ( const auto& handle : get_handles() )
+    {
+        attributed = attributed || handle.self;
+        efficiency = efficiency || handle.isEfficiency();
+    }
+    if ( attributed )
+    {
+        const std::string attribution = scorep::environment_variable::get( "ATTRIBUTION", "cgroup" );
+        if ( attribution != "cgroup" && attribution != "process" )
+        {
+            logging::warn() << "Unknown value '" << attribution << "' for " << scorep::environment_variable::name( "ATTRIBUTION" ) << ". Expected cgroup or process. Using cgroup";
+        }
+        try
+        {
+            measurement.attribute_cpu_energy( std::unique_ptr<CpuAccounting>(
+                                                  new CpuAccounting( attribution == "process" ? CpuAccounting::Scope::process : CpuAccounting::Scope::cgroup ) ) );
+        }
+        catch ( const std::runtime_error& e )
+        {
+            logging::warn() << e.what() << ". The :SELF metrics report the energy of the whole node";
+        }
+    }
+    if ( efficiency )
+    {
+        // J_per_Ginstr relates the instructions to the energy of the CPUs, if available
+        unsigned int energy_domain_idx = ~0u;
+        for ( const char* cpu_domain : cpu_domains )
+        {
+            const auto it = this->domain_by_name.find( cpu_domain );
+            if ( it != this->domain_by_name.end() )
+            {
+                energy_domain_idx = it->second.idx;
+            }
+        }
+        measurement.co_sample_efficiency( std::unique_ptr<EfficiencyCounters>( new EfficiencyCounters( "/sys/devices/system/cpu" ) ),
+                                          energy_domain_idx );
+    }
+    measurement.start( std::move( this->backend ), get_handles() );
+
+    const std::string control_path = scorep::environment_variable::get( "CONTROL", "" );
+    if ( control_path != "" )
+    {
+        try
+        {
+            control.reset( new ControlFile( control_path, [ this ]( const ControlFile::Settings& settings ){
+                    this->reconfigure( settings );
+                } ) );
+            logging::info() << "Watching the control file '" << control_path << "'";
+        }
+        catch ( const std::runtime_error& e )
+        {
+            logging::warn() << "Runtime reconfiguration disabled: " << e.what();
+        }
+    }
+    std::lock_guard<std::mutex> lock( active_measurement_mutex );
+    active_measurement = &measurement;
+}
+
+
+void
+meric_plugin::reconfigure( const ControlFile::Settings& settings )
+{
+    if ( settings.has_interval )
+    {
+        if ( attached )
+        {
+            logging::warn() << "The interval of the sampling daemon cannot be changed, ignoring interval=" << settings.interval.count() << "us";
+        }
+        else if ( measurement.set_interval( settings.interval ) )
+        {
+            logging::info() << "Sampling interval changed to " << measurement.interval().count() << " us";
+        }
+    }
+    if ( settings.has_domains )
+    {
+        std::vector<bool> disabled;
+        if ( !settings.domains.empty() )
+        {
+            for ( const auto& domain : this->domain_by_name )
+            {
+                disabled.resize( std::max<std::size_t>( disabled.size(), domain.second.idx + 1 ), true );
+            }
+            for ( const auto& name : settings.domains )
+            {
+                const auto it = this->domain_by_name.find( name );
+                if ( it == this->domain_by_name.end() )
+                {
+                    logging::warn() << "Domain " << name << " is not measured, ignoring it in the control file";
+                    continue;
+                }
+                disabled[ it->second.idx ] = false;
+            }
+        }
+        measurement.mask_domains( std::move( disabled ) );
+    }
+    if ( settings.has_burst )
+    {
+        if ( settings.burst )
+        {
+            measurement.begin_burst( settings.burst_interval, settings.burst_duration );
+        }
+        else
+        {
+            measurement.end_burst();
+        }
+    }
 }
 
 
 void
 meric_plugin::stop()
 {
-    this->extlib = measurement.stop();
+    {
+        std::lock_guard<std::mutex> lock( active_measurement_mutex );
+        active_measurement = nullptr;
+    }
+    control.reset();
+    this->backend = measurement.stop();
+
+    char hostname[ 256 ] = { 0 };
+    gethostname( hostname, sizeof( hostname ) - 1 );
+    const std::string name = output_name();
+
+    const std::string sidecar_dir = scorep::environment_variable::get( "SIDECAR", "" );
+    if ( sidecar_dir != "" )
+    {
+        const std::string path = sidecar_dir + "/" + name + ".sidecar";
+        try
+        {
+            write_sidecar( path, hostname, measurement );
+            logging::info() << "Wrote " << measurement.samples().size() << " samples to " << path;
+        }
+        catch ( const std::exception& e )
+        {
+            logging::warn() << "Could not write side-car file: " << e.what();
+        }
+    }
+    // Only the readings prepared by stop() are written to the trace, so that the samples
+    // do not stay in memory next to them until Score-P collects the values
+    measurement.release_samples();
+
+    const auto& histograms = measurement.histograms();
+    for ( std::size_t column = 0; column < histograms.size(); ++column )
+    {
+        if ( measurement.metrics()[ column ]->isEnergy() )
+        {
+            logging::info() << measurement.metrics()[ column ]->name() << " power: p50 " << histograms[ column ].percentile( 0.5 )
+                            << " W, p99 " << histograms[ column ].percentile( 0.99 ) << " W";
+        }
+    }
+    const std::string histogram_dir = scorep::environment_variable::get( "HISTOGRAM", "" );
+    if ( histogram_dir != "" )
+    {
+        const std::string path = histogram_dir + "/" + name + ".histogram.csv";
+        try
+        {
+            write_histograms( path, measurement );
+            logging::info() << "Wrote power histograms to " << path;
+        }
+        catch ( const std::exception& e )
+        {
+            logging::warn() << "Could not write histogram file: " << e.what();
+        }
+    }
+
+    const std::string summary_dir = scorep::environment_variable::get( "SUMMARY", "" );
+    if ( summary_dir != "" )
+    {
+        const bool        csv  = scorep::environment_variable::get( "SUMMARY_FORMAT", "json" ) == "csv";
+        const std::string path = summary_dir + "/" + name + ( csv ? ".summary.csv" : ".summary.json" );
+        try
+        {
+            write_summary( path, hostname, measurement, csv ? SummaryFormat::csv : SummaryFormat::json );
+            logging::info() << "Wrote energy summary to " << path;
+        }
+        catch ( const std::exception& e )
+        {
+            logging::warn() << "Could not write summary file: " << e.what();
+        }
+    }
 }
 
 
@@ -175,14 +710,49 @@ meric_plugin::get_all_values( Metric& metric, C& cursor )
 {
     logging::debug() << "Reading all recorded values for " << metric.name();
 
-    // write the collected data to the cursor.
-    for ( auto& tvpair : measurement.readings( metric ) )
+    // The readings were already prepared per metric when the measurement stopped
+    write_readings( measurement.readings( metric ), cursor );
+}
+}
+
+using namespace MericPlugin;
+
+// Only the per-host plugin exports the burst control API, so that both plugins can be loaded together
+#ifndef MERIC_PLUGIN_PER_PROCESS
+extern "C" int
+meric_plugin_burst_begin( unsigned long interval_us, unsigned long duration_us )
+{
+    std::lock_guard<std::mutex> lock( active_measurement_mutex );
+    // Larger values would turn negative as std::chrono::microseconds
+    const unsigned long max_us = std::chrono::duration_cast<std::chrono::microseconds>( max_duration ).count();
+    if ( !active_measurement || interval_us > max_us )
     {
-        cursor.write( tvpair.first, tvpair.second );
+        return -1;
     }
+    const bool started = active_measurement->begin_burst( std::chrono::microseconds( interval_us ),
+                                                          std::chrono::microseconds( std::min( duration_us, max_us ) ) );
+    return started ? 0 : -1;
 }
+
+
+extern "C" int
+meric_plugin_burst_end( void )
+{
+    std::lock_guard<std::mutex> lock( active_measurement_mutex );
+    if ( !active_measurement )
+    {
+        return -1;
+    }
+    active_measurement->end_burst();
+    return 0;
 }
+#endif
 
-using namespace MericPlugin;
 
+#ifdef MERIC_PLUGIN_PER_PROCESS
+// The entry point is named after the class, and Score-P looks it up by the library name
+using meric_gpu_plugin = MericPlugin::meric_plugin;
+SCOREP_METRIC_PLUGIN_CLASS( meric_gpu_plugin, "meric_gpu" )
+#else
 SCOREP_METRIC_PLUGIN_CLASS( meric_plugin, "meric" )
+#endif
@@ -8,7 +8,8 @@
 #pragma once
 
 #include "MeasurementThread.h"
-#include "ExtlibWrapper.h"
+#include "ControlFile.h"
+#include "EnergyBackend.h"
 
 #include <scorep/plugin/plugin.hpp>
 
@@ -22,9 +23,18 @@ template <typename P, typename Policies>
 using meric_object_id = scorep::plugin::policy::object_id<Metric, P, Policies>;
 
 
+/*
+ * The same class is built twice: as meric_plugin, once per host for all domains, and with
+ * MERIC_PLUGIN_PER_PROCESS as meric_gpu_plugin, once per process for the GPU domains,
+ * restricted to the devices of the process.
+ */
 class meric_plugin : public scorep::plugin::base<meric_plugin,
                                                  scorep::plugin::policy::async,
+#ifdef MERIC_PLUGIN_PER_PROCESS
+                                                 scorep::plugin::policy::per_process,
+#else
                                                  scorep::plugin::policy::per_host,
+#endif
                                                  scorep::plugin::policy::post_mortem,
                                                  scorep::plugin::policy::scorep_clock,
                                                  meric_object_id>
@@ -51,13 +61,34 @@ public:
 
 private:
 
-    MeasurementThread measurement;
-    ExtlibWrapper     extlib;
+    MeasurementThread              measurement;
+    std::unique_ptr<EnergyBackend> backend;
+
+    std::unordered_map<std::string, Domain> domain_by_name;
+    bool                                    attached = false; // To a meric_sampld daemon
 
-    std::unordered_map<std::string, ExtlibWrapper::Domain> domain_by_name;
+    std::unique_ptr<ControlFile> control; // While the measurement runs
 
 private:
+    // Applies the settings of the control file to the running measurement
+    void
+    reconfigure( const ControlFile::Settings& settings );
+
     static std::vector<unsigned int>
     requested_domain_ids( std::string env_str );
+
+    static std::vector<MeasurementThread::BurstWindow>
+    burst_schedule( std::string env_str );
+
+    // The backend selected by the options, with its decorators, for sampling every `interval`
+    static std::unique_ptr<EnergyBackend>
+    make_energy_backend( std::chrono::microseconds interval );
+
+    static std::unordered_map<std::string, Domain>
+    domains_from_metric_names( const std::vector<std::string>& names );
+
+    // Base name of the files written at stop(), unique per host, or per process
+    static std::string
+    output_name();
 };
 }
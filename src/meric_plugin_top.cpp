@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "TelemetryRing.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using namespace MericPlugin;
+
+static void
+usage( const char* argv0 )
+{
+    std::cerr << "Usage: " << argv0 << " [-n SHM_NAME] [-r REFRESH_MS] [-c COUNT]" << std::endl
+              << "Show the live power per energy metric published by the meric plugin," << std::endl
+              << "and the mean per sample of the other metrics." << std::endl
+              << "SHM_NAME defaults to $SCOREP_METRIC_MERIC_PLUGIN_SHM or /meric_plugin" << std::endl;
+}
+
+
+int
+main( int argc, char** argv )
+{
+    const char* env_name   = std::getenv( "SCOREP_METRIC_MERIC_PLUGIN_SHM" );
+    std::string name       = env_name ? env_name : "/meric_plugin";
+    long        refresh_ms = 1000;
+    long        count      = -1; // Number of refreshes, -1 runs until interrupted
+
+    int opt;
+    while ( ( opt = getopt( argc, argv, "n:r:c:h" ) ) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'n':
+                name = optarg;
+                break;
+            case 'r':
+                refresh_ms = std::atol( optarg );
+                break;
+            case 'c':
+                count = std::atol( optarg );
+                break;
+            default:
+                usage( argv[ 0 ] );
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    try
+    {
+        TelemetryRingReader ring( name );
+        const auto&         names     = ring.metric_names();
+        const auto&         units     = ring.metric_units();
+        const bool          is_tty    = isatty( STDOUT_FILENO );
+        std::uint64_t       last_seen = ring.write_index();
+
+        TelemetryRing::Sample sample;
+        std::vector<double>   sums( names.size() );
+        for ( long iteration = 0; count < 0 || iteration < count; ++iteration )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( refresh_ms ) );
+
+            // Average over all samples since the last refresh that are still in the ring
+            const std::uint64_t end      = ring.write_index();
+            std::uint64_t       begin    = end > ring.num_slots() && last_seen < end - ring.num_slots() ? end - ring.num_slots() : last_seen;
+            std::uint64_t       duration = 0;
+            std::uint64_t       samples  = 0;
+            std::uint64_t       missed   = begin - last_seen;
+            std::fill( sums.begin(), sums.end(), 0. );
+            for ( std::uint64_t index = begin; index < end; ++index )
+            {
+                if ( !ring.read( index, sample ) )
+                {
+                    ++missed;
+                    continue;
+                }
+                ++samples;
+                duration += sample.duration_ns;
+                for ( std::size_t i = 0; i < sums.size(); ++i )
+                {
+                    sums[ i ] += sample.values[ i ];
+                }
+            }
+            last_seen = end;
+
+            if ( is_tty )
+            {
+                std::cout << "\033[H\033[2J";
+            }
+            std::cout << name << ": " << samples << " samples";
+            if ( missed > 0 )
+            {
+                std::cout << ", " << missed << " overwritten";
+            }
+            std::cout << std::endl;
+            if ( duration == 0 )
+            {
+                std::cout << "(no new samples)" << std::endl;
+                continue;
+            }
+            for ( std::size_t i = 0; i < names.size(); ++i )
+            {
+                // Energy becomes power, the other metrics are averaged per sample
+                const bool is_energy = units[ i ] == "J";
+                std::cout << std::left << std::setw( 40 ) << names[ i ]
+                          << std::right << std::setw( 12 ) << std::fixed << std::setprecision( 2 )
+                          << ( is_energy ? sums[ i ] / ( duration * 1e-9 ) : sums[ i ] / samples )
+                          << " " << ( is_energy ? "W" : units[ i ] ) << std::endl;
+            }
+        }
+    }
+    catch ( const std::exception& e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
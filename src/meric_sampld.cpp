@@ -0,0 +1,154 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Node-local sampling daemon.
+ *
+ * Samples all counters of the enabled domains continuously into a shared-memory ring.
+ * Plugins started with SCOREP_METRIC_MERIC_PLUGIN_DAEMON=<name> attach to the ring and
+ * copy the samples of their own run, instead of initializing a backend and sampling
+ * themselves. Any number of jobs on the node can share one daemon.
+ */
+#include "EnergyBackend.h"
+#include "MeasurementThread.h"
+#include "Watchdog.h"
+#include "utils.h"
+
+#include <scorep/plugin/log.hpp>
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+using namespace MericPlugin;
+
+
+// Outside of Score-P, the samples are stamped with CLOCK_MONOTONIC nanoseconds
+static scorep::chrono::ticks
+monotonic_ticks()
+{
+    return scorep::chrono::ticks( TelemetryRing::monotonic_ns() );
+}
+
+
+static void
+usage( const char* argv0 )
+{
+    std::cerr << "Usage: " << argv0 << " [-n NAME] [-i INTERVAL_US] [-d DOMAINS] [-b BACKEND] [-s SLOTS]" << std::endl
+              << "Sample all counters into the shared-memory ring NAME (default /meric_sampld) until" << std::endl
+              << "SIGINT or SIGTERM. The defaults of the other options are taken from the" << std::endl
+              << "SCOREP_METRIC_MERIC_PLUGIN_* variables, like in the plugin." << std::endl;
+}
+
+
+int
+main( int argc, char** argv )
+{
+    std::string name        = "/meric_sampld";
+    std::string interval_us = get_option( "INTERVAL_US", "50000" );
+    std::string domains     = get_option( "DOMAINS", "ALL" );
+    std::string backend     = get_option( "BACKEND", "extlib" );
+    std::string slots       = "65536";
+    int         opt;
+    while ( ( opt = getopt( argc, argv, "n:i:d:b:s:h" ) ) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'n':
+                name = optarg;
+                break;
+            case 'i':
+                interval_us = optarg;
+                break;
+            case 'd':
+                domains = optarg;
+                break;
+            case 'b':
+                backend = optarg;
+                break;
+            case 's':
+                slots = optarg;
+                break;
+            default:
+                usage( argv[ 0 ] );
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    std::vector<unsigned int> domain_ids;
+    if ( domains == "ALL" )
+    {
+        domain_ids = EnergyBackend::all_domain_ids();
+    }
+    else
+    {
+        for ( const auto& domain : split_string( domains, ',' ) )
+        {
+            const auto it = EnergyBackend::domain_id_by_name.find( domain );
+            if ( it == EnergyBackend::domain_id_by_name.end() )
+            {
+                std::cerr << "Unknown domain '" << domain << "'" << std::endl;
+                return 1;
+            }
+            domain_ids.push_back( it->second );
+        }
+    }
+
+    // Block the signals before any thread is started, so that only sigwait() receives them
+    sigset_t signals;
+    sigemptyset( &signals );
+    sigaddset( &signals, SIGINT );
+    sigaddset( &signals, SIGTERM );
+    pthread_sigmask( SIG_BLOCK, &signals, nullptr );
+
+    try
+    {
+        const std::chrono::microseconds interval( std::stoll( interval_us ) );
+        std::unique_ptr<EnergyBackend>  energy = guard_against_wraps( make_backend( backend, domain_ids ), interval );
+
+        // Every counter, the domain totals and the total, named like the plugin metrics
+        std::vector<Metric> handles;
+        handles.emplace_back( Metric::Total() );
+        for ( const auto& domain : energy->query_enabled_domains() )
+        {
+            handles.emplace_back( Metric::DomainTotal(), domain.second.idx, domain.second.id, domain.first );
+            for ( const auto& counter : domain.second.counter_idx_by_name )
+            {
+                handles.emplace_back( Metric::Single(), domain.second.idx, domain.second.id, domain.first, counter.second, counter.first );
+            }
+        }
+        std::vector<std::string> names;
+        std::vector<std::string> units;
+        for ( const auto& handle : handles )
+        {
+            names.push_back( handle.name() );
+            units.push_back( handle.unit() );
+        }
+
+        MeasurementThread               measurement( interval, {}, &monotonic_ticks );
+        measurement.keep_histograms( false, false );
+        measurement.publish_to( std::unique_ptr<TelemetryRingWriter>(
+                                    new TelemetryRingWriter( name, names, units, std::stoull( slots ), interval.count() ) ) );
+        measurement.start( std::move( energy ), handles );
+        std::cerr << "Sampling " << names.size() << " metrics every " << interval.count() << " us into '" << name << "'" << std::endl;
+
+        int signal;
+        sigwait( &signals, &signal );
+        measurement.stop();
+    }
+    catch ( const std::exception& e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "meric_sidecar.h"
+
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+
+using namespace MericPlugin;
+
+static void
+usage( const char* argv0 )
+{
+    std::cerr << "Usage: " << argv0 << " [-w WINDOW_S] [-m METRIC] [-j THREADS] FILE" << std::endl
+              << "Without -w, print the metric table of a meric side-car file." << std::endl
+              << "With -w, print the energy, mean and peak power per window of WINDOW_S seconds as CSV," << std::endl
+              << "or the mean and peak value for metrics that are not in J." << std::endl;
+}
+
+
+int
+main( int argc, char** argv )
+{
+    double       window_s    = 0.;
+    std::string  metric_name = "";
+    unsigned int num_threads = std::thread::hardware_concurrency();
+
+    int opt;
+    while ( ( opt = getopt( argc, argv, "w:m:j:h" ) ) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'w':
+                window_s = std::atof( optarg );
+                break;
+            case 'm':
+                metric_name = optarg;
+                break;
+            case 'j':
+                num_threads = std::atoi( optarg );
+                break;
+            default:
+                usage( argv[ 0 ] );
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if ( optind != argc - 1 )
+    {
+        usage( argv[ 0 ] );
+        return 1;
+    }
+
+    try
+    {
+        SidecarReader reader( argv[ optind ] );
+
+        if ( window_s <= 0. )
+        {
+            const auto timestamps = reader.timestamps();
+            std::cout << "Host:    " << reader.hostname() << std::endl
+                      << "Samples: " << reader.num_samples() << std::endl;
+            if ( timestamps.size > 0 )
+            {
+                std::cout << "Span:    " << std::fixed << std::setprecision( 3 )
+                          << reader.to_realtime_seconds( timestamps[ timestamps.size - 1 ] )
+                    - reader.to_realtime_seconds( timestamps[ 0 ] ) << " s" << std::endl;
+            }
+            // The total energy, or the mean per sample of the other metrics
+            std::cout << "Metrics:" << std::endl;
+            for ( std::size_t metric = 0; metric < reader.num_metrics(); ++metric )
+            {
+                double      total   = 0.;
+                std::size_t samples = 0;
+                for ( double value : reader.values( metric ) )
+                {
+                    if ( !std::isnan( value ) )
+                    {
+                        total += value;
+                        ++samples;
+                    }
+                }
+                const bool is_energy = reader.unit( metric ) == "J";
+                std::cout << "  " << std::left << std::setw( 40 ) << reader.metric_names()[ metric ]
+                          << std::right << std::setw( 16 ) << std::fixed << std::setprecision( 3 )
+                          << ( is_energy || samples == 0 ? total : total / samples ) << " " << reader.unit( metric )
+                          << ( is_energy ? "" : " mean" ) << std::endl;
+            }
+            return 0;
+        }
+
+        // Columns that do not apply to the unit of a metric stay empty
+        std::cout << "metric,unit,begin_s,end_s,energy_J,mean_power_W,peak_power_W,mean,peak,samples" << std::endl;
+        auto field = []( double value ){
+                         std::ostringstream ss;
+                         if ( !std::isnan( value ) )
+                         {
+                             ss << value;
+                         }
+                         return ss.str();
+                     };
+        auto print = [ & ]( std::size_t metric, const std::vector<IntervalStats>& stats ){
+                         for ( const auto& s : stats )
+                         {
+                             std::cout << reader.metric_names()[ metric ] << "," << reader.unit( metric ) << ","
+                                       << s.begin_s << "," << s.end_s << ","
+                                       << field( s.energy_j ) << "," << field( s.mean_power_w ) << "," << field( s.peak_power_w ) << ","
+                                       << field( s.mean_value ) << "," << field( s.peak_value ) << ","
+                                       << s.samples << std::endl;
+                         }
+                     };
+        if ( metric_name != "" )
+        {
+            const long metric = reader.find_metric( metric_name );
+            if ( metric < 0 )
+            {
+                std::cerr << "Metric '" << metric_name << "' is not in " << argv[ optind ] << std::endl;
+                return 1;
+            }
+            print( metric, interval_stats( reader, metric, window_s ) );
+            return 0;
+        }
+        const auto all_stats = interval_stats( reader, window_s, num_threads );
+        for ( std::size_t metric = 0; metric < all_stats.size(); ++metric )
+        {
+            print( metric, all_stats[ metric ] );
+        }
+    }
+    catch ( const std::exception& e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,303 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Combine the per-host summary files of the plugin into a job-level roll-up.
+ *
+ * The plugin stops after MPI is finalized, so it cannot reduce across ranks itself.
+ * Run this tool on the summary directory after the job instead.
+ */
+#include "utils.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+using MericPlugin::json_quote;
+using Record = std::map<std::string, std::string>;
+
+static void
+usage( const char* argv0 )
+{
+    std::cerr << "Usage: " << argv0 << " [-j] FILE..." << std::endl
+              << "Combine meric_<host>.summary.json or .csv files into one row per metric, as CSV," << std::endl
+              << "or with -j as JSON." << std::endl;
+}
+
+
+static std::vector<std::string>
+split_csv( const std::string& line )
+{
+    std::vector<std::string> fields;
+    std::string::size_type   begin = 0;
+    while ( true )
+    {
+        const auto comma = line.find( ',', begin );
+        fields.push_back( line.substr( begin, comma - begin ) );
+        if ( comma == std::string::npos )
+        {
+            return fields;
+        }
+        begin = comma + 1;
+    }
+}
+
+
+// The JSON string starting with the quote at `pos`, unescaped. Returns the position after
+// the closing quote, or npos if the string does not end on this line.
+static std::string::size_type
+parse_json_string( const std::string& line, std::string::size_type pos, std::string& text )
+{
+    text.clear();
+    for ( ++pos; pos < line.size(); ++pos )
+    {
+        if ( line[ pos ] == '"' )
+        {
+            return pos + 1;
+        }
+        if ( line[ pos ] != '\\' || pos + 1 >= line.size() )
+        {
+            text += line[ pos ];
+            continue;
+        }
+        ++pos;
+        if ( line[ pos ] == 'u' && pos + 4 < line.size() )
+        {
+            // json_quote() only escapes control characters this way
+            text += char( std::strtoul( line.substr( pos + 1, 4 ).c_str(), nullptr, 16 ) );
+            pos  += 4;
+        }
+        else
+        {
+            text += line[ pos ] == 'n' ? '\n' : line[ pos ] == 't' ? '\t' : line[ pos ];
+        }
+    }
+    return std::string::npos;
+}
+
+
+// The "key": value pairs of one line of a summary JSON file, which has no nested objects per line
+static Record
+parse_json_line( const std::string& line )
+{
+    Record                 record;
+    std::string::size_type pos = 0;
+    std::string            key;
+    while ( ( pos = line.find( '"', pos ) ) != std::string::npos )
+    {
+        const auto key_end = parse_json_string( line, pos, key );
+        const auto colon   = key_end == std::string::npos ? key_end : line.find( ':', key_end );
+        if ( colon == std::string::npos )
+        {
+            break;
+        }
+        auto value_begin = line.find_first_not_of( ' ', colon + 1 );
+        if ( value_begin == std::string::npos || line[ value_begin ] == '[' )
+        {
+            break;
+        }
+        std::string::size_type value_end;
+        if ( line[ value_begin ] == '"' )
+        {
+            value_end = parse_json_string( line, value_begin, record[ key ] );
+        }
+        else
+        {
+            value_end     = line.find_first_of( ",}", value_begin );
+            record[ key ] = line.substr( value_begin, value_end - value_begin );
+        }
+        pos = value_end;
+    }
+    return record;
+}
+
+
+// One record per metric, with the host fields
+static std::vector<Record>
+read_summary( const std::string& path )
+{
+    std::ifstream in( path );
+    if ( !in )
+    {
+        throw std::runtime_error( "Could not open '" + path + "'" );
+    }
+    std::vector<Record> records;
+    std::string         line;
+    const bool          csv = path.size() >= 4 && path.compare( path.size() - 4, 4, ".csv" ) == 0;
+    if ( csv )
+    {
+        std::getline( in, line );
+        const auto header = split_csv( line );
+        while ( std::getline( in, line ) )
+        {
+            const auto fields = split_csv( line );
+            Record     record;
+            for ( std::size_t i = 0; i < header.size() && i < fields.size(); ++i )
+            {
+                record[ header[ i ] ] = fields[ i ];
+            }
+            records.push_back( record );
+        }
+        return records;
+    }
+
+    Record host;
+    while ( std::getline( in, line ) )
+    {
+        Record record = parse_json_line( line );
+        if ( record.count( "host" ) )
+        {
+            host = record;
+        }
+        else if ( record.count( "metric" ) )
+        {
+            record.insert( host.begin(), host.end() );
+            records.push_back( record );
+        }
+    }
+    return records;
+}
+
+
+static double
+number( const Record& record, const std::string& key )
+{
+    const auto it = record.find( key );
+    return it == record.end() || it->second == "null" || it->second == "" ? NAN : std::atof( it->second.c_str() );
+}
+
+
+static std::uint64_t
+count( const Record& record, const std::string& key )
+{
+    const auto it = record.find( key );
+    return it == record.end() ? 0 : std::strtoull( it->second.c_str(), nullptr, 10 );
+}
+
+
+struct JobMetric
+{
+    std::string   unit;
+    unsigned int  hosts         = 0;
+    unsigned int  missing_hosts = 0; // Hosts without an energy value, left out of the sums
+    std::uint64_t samples       = 0;
+    std::uint64_t missed_ticks  = 0;
+    double        duration_s    = 0.;
+    double        energy_j      = 0.;
+    double        mean_power_w  = 0.;
+    double        peak_power_w  = 0.; // Sum of the host peaks, an upper bound of the job peak
+    double        max_host_peak = -INFINITY;
+};
+
+
+int
+main( int argc, char** argv )
+{
+    bool json = false;
+    int  opt;
+    while ( ( opt = getopt( argc, argv, "jh" ) ) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'j':
+                json = true;
+                break;
+            default:
+                usage( argv[ 0 ] );
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if ( optind >= argc )
+    {
+        usage( argv[ 0 ] );
+        return 1;
+    }
+
+    std::map<std::string, JobMetric> job;
+    try
+    {
+        for ( int arg = optind; arg < argc; ++arg )
+        {
+            for ( const auto& record : read_summary( argv[ arg ] ) )
+            {
+                auto& metric = job[ record.at( "metric" ) ];
+                metric.unit = record.count( "unit" ) ? record.at( "unit" ) : "J";
+                metric.hosts++;
+                metric.samples      += count( record, "samples" );
+                metric.missed_ticks += count( record, "missed_ticks" );
+                const double duration = number( record, "duration_s" );
+                const double energy   = number( record, "energy_j" );
+                const double power    = number( record, "mean_power_w" );
+                if ( std::isnan( energy ) || std::isnan( power ) )
+                {
+                    std::cerr << "No energy of " << record.at( "metric" ) << " on host "
+                              << ( record.count( "host" ) ? record.at( "host" ) : "?" ) << " in " << argv[ arg ]
+                              << ", left out of the job total" << std::endl;
+                    metric.missing_hosts++;
+                    continue;
+                }
+                metric.duration_s    = std::max( metric.duration_s, duration );
+                metric.energy_j     += energy;
+                metric.mean_power_w += power;
+                const double peak = number( record, "peak_power_w" );
+                if ( std::isfinite( peak ) )
+                {
+                    metric.peak_power_w += peak;
+                    metric.max_host_peak = std::max( metric.max_host_peak, peak );
+                }
+            }
+        }
+    }
+    catch ( const std::exception& e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if ( !json )
+    {
+        std::cout << "metric,unit,hosts,missing_hosts,samples,missed_ticks,duration_s,energy_j,mean_power_w,peak_power_sum_w,max_host_peak_power_w" << std::endl;
+    }
+    else
+    {
+        std::cout << "[" << std::endl;
+    }
+    bool first = true;
+    for ( const auto& it : job )
+    {
+        const auto& m = it.second;
+        if ( !json )
+        {
+            std::cout << it.first << "," << m.unit << "," << m.hosts << "," << m.missing_hosts << "," << m.samples << "," << m.missed_ticks << ","
+                      << m.duration_s << "," << m.energy_j << "," << m.mean_power_w << "," << m.peak_power_w << ","
+                      << m.max_host_peak << std::endl;
+            continue;
+        }
+        std::cout << ( first ? "" : ",\n" )
+                  << "  { \"metric\": " << json_quote( it.first ) << ", \"unit\": " << json_quote( m.unit ) << ", \"hosts\": " << m.hosts
+                  << ", \"missing_hosts\": " << m.missing_hosts << ", \"samples\": " << m.samples << ", \"missed_ticks\": " << m.missed_ticks
+                  << ", \"duration_s\": " << m.duration_s << ", \"energy_j\": " << m.energy_j
+                  << ", \"mean_power_w\": " << m.mean_power_w << ", \"peak_power_sum_w\": " << m.peak_power_w
+                  << ", \"max_host_peak_power_w\": " << ( std::isfinite( m.max_host_peak ) ? m.max_host_peak : 0. ) << " }";
+        first = false;
+    }
+    if ( json )
+    {
+        std::cout << "\n]" << std::endl;
+    }
+    return 0;
+}
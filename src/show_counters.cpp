@@ -4,22 +4,160 @@
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
-#include "ExtlibWrapper.h"
+#include "EnergyBackend.h"
+#include "utils.h"
 
 #include <scorep/plugin/log.hpp>
 
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <string>
+#include <vector>
 
 
 using namespace MericPlugin;
+using ProbeClock = std::chrono::steady_clock;
+
+
+static double
+cpu_seconds()
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static double
+percentile( const std::vector<double>& sorted, double p )
+{
+    return sorted.empty() ? 0. : sorted[ std::size_t( p * ( sorted.size() - 1 ) ) ];
+}
+
+
+/*
+ * Read one domain back-to-back for `duration`. Reports the read latency distribution,
+ * how often the counters actually change, and recommends a sampling interval: the
+ * update period of the fastest counter, but at least ten times the read cost, so that
+ * the sampler stays below 10 % of a core.
+ */
+static void
+probe_domain( const std::string& backend_name, const Domain& domain, double duration )
+{
+    // Bounds the memory for the latency distribution, reads continue for `duration`
+    const std::size_t max_latencies = 1000000;
+    auto              backend   = make_backend( backend_name, { domain.id } );
+
+    EnergyReading prev, cur;
+    backend->read( prev );
+
+    std::vector<double>               latencies;
+    std::vector<std::vector<double> > changes( domain.counter_idx_by_name.size() );
+    const auto                        begin     = ProbeClock::now();
+    const double                      cpu_begin = cpu_seconds();
+    double                            elapsed   = 0.;
+    std::size_t                       num_reads = 0;
+    for ( ; elapsed < duration; ++num_reads )
+    {
+        const auto read_begin = ProbeClock::now();
+        backend->read( cur );
+        const auto read_end = ProbeClock::now();
+        if ( latencies.size() < max_latencies )
+        {
+            latencies.push_back( std::chrono::duration<double>( read_end - read_begin ).count() );
+        }
+        elapsed = std::chrono::duration<double>( read_end - begin ).count();
+
+        const auto& counters      = cur.domain_data[ domain.idx ].energy_per_counter;
+        const auto& prev_counters = prev.domain_data[ domain.idx ].energy_per_counter;
+        for ( std::size_t counter = 0; counter < changes.size() && counter < counters.size(); ++counter )
+        {
+            if ( counters[ counter ] != prev_counters[ counter ] )
+            {
+                changes[ counter ].push_back( elapsed );
+            }
+        }
+        std::swap( prev, cur );
+    }
+    const double cpu_per_read = ( cpu_seconds() - cpu_begin ) / num_reads;
+    std::sort( latencies.begin(), latencies.end() );
+
+    std::cout << domain.name() << ": " << num_reads << " reads in " << elapsed << " s" << std::endl;
+    std::cout << "  read latency [us]: p50 " << percentile( latencies, 0.5 ) * 1e6
+              << ", p90 " << percentile( latencies, 0.9 ) * 1e6
+              << ", p99 " << percentile( latencies, 0.99 ) * 1e6
+              << ", max " << percentile( latencies, 1. ) * 1e6 << std::endl;
+
+    // Median period between changes, per counter
+    double fastest_period = INFINITY;
+    for ( const auto& counter : domain.counter_idx_by_name )
+    {
+        const auto&         times = changes[ counter.second ];
+        std::vector<double> periods;
+        for ( std::size_t i = 1; i < times.size(); ++i )
+        {
+            periods.push_back( times[ i ] - times[ i - 1 ] );
+        }
+        std::sort( periods.begin(), periods.end() );
+        std::cout << "  " << counter.first << ": ";
+        if ( periods.empty() )
+        {
+            std::cout << "changed " << times.size() << " times" << std::endl;
+            continue;
+        }
+        const double period = percentile( periods, 0.5 );
+        fastest_period = std::min( fastest_period, period );
+        std::cout << "changes every " << std::llround( period * 1e6 ) << " us (" << times.size() << " changes)" << std::endl;
+    }
+
+    if ( std::isinf( fastest_period ) )
+    {
+        std::cout << "  No counter changed regularly, probe for longer to get a recommendation" << std::endl;
+        return;
+    }
+    const double interval = std::max( fastest_period, 10. * cpu_per_read );
+    std::cout << "  recommended INTERVAL_US=" << std::llround( interval * 1e6 )
+              << ", costing " << 100. * cpu_per_read / interval << " % of a core" << std::endl;
+}
+
 
 int
-main()
+main( int argc, char** argv )
 {
     // Silence warnings and info emitted by the plugin
     scorep::plugin::log::set_min_severity_level( nitro::log::severity_level::error );
 
-    const auto   domains     = ExtlibWrapper( ExtlibWrapper::all_domain_ids() ).query_enabled_domains();
+    double probe_duration = 0.;
+    if ( argc > 1 && std::strcmp( argv[ 1 ], "--probe" ) == 0 )
+    {
+        probe_duration = argc > 2 ? std::stod( argv[ 2 ] ) : 3.;
+    }
+    else if ( argc > 1 )
+    {
+        std::cout << "Usage: " << argv[ 0 ] << " [--probe [SECONDS]]" << std::endl;
+        return 1;
+    }
+
+    // Use the same backend as the plugin would
+    const std::string              backend_name = get_option( "BACKEND", "extlib" );
+    std::unique_ptr<EnergyBackend> backend;
+    try
+    {
+        backend = make_backend( backend_name, EnergyBackend::all_domain_ids() );
+    }
+    catch ( const std::invalid_argument& e )
+    {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+
+    const auto   domains     = backend->query_enabled_domains();
     unsigned int num_domains = domains.size();
 
     if ( num_domains == 0 )
@@ -49,5 +187,16 @@ main()
         return 1;
     }
 
+    if ( probe_duration > 0. )
+    {
+        // Probe each domain on its own, so that reads of other domains do not add up
+        backend.reset();
+        std::cout << std::endl << std::setprecision( 3 );
+        for ( const auto& it : domains )
+        {
+            probe_domain( backend_name, it.second, probe_duration );
+        }
+    }
+
     return 0;
 }
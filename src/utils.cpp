@@ -6,7 +6,11 @@
  */
 #include "utils.h"
 
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -63,4 +67,90 @@ join_strings( const std::vector<std::string>& strings, std::string delim )
     }
     return ss.str();
 }
+
+std::string
+json_quote( const std::string& text )
+{
+    std::string json = "\"";
+    for ( const char c : text )
+    {
+        if ( c == '"' || c == '\\' )
+        {
+            json += '\\';
+            json += c;
+        }
+        else if ( static_cast<unsigned char>( c ) < 0x20 )
+        {
+            char escaped[ 8 ];
+            std::snprintf( escaped, sizeof( escaped ), "\\u%04x", c );
+            json += escaped;
+        }
+        else
+        {
+            json += c;
+        }
+    }
+    return json + "\"";
+}
+
+
+std::string
+get_option( const std::string& name, const std::string& default_value )
+{
+#ifdef MERIC_PLUGIN_PER_PROCESS
+    const char* value = std::getenv( ( "SCOREP_METRIC_MERIC_GPU_PLUGIN_" + name ).c_str() );
+#else
+    const char* value = std::getenv( ( "SCOREP_METRIC_MERIC_PLUGIN_" + name ).c_str() );
+#endif
+    return value ? value : default_value;
+}
+
+
+std::chrono::microseconds
+parse_duration( const std::string& str )
+{
+    // stoull accepts leading spaces and signs, and wraps negative numbers
+    if ( str.empty() || !std::isdigit( static_cast<unsigned char>( str[ 0 ] ) ) )
+    {
+        throw std::invalid_argument( "Invalid duration '" + str + "'" );
+    }
+    size_t             pos   = 0;
+    unsigned long long value = 0;
+    try
+    {
+        value = std::stoull( str, &pos );
+    }
+    catch ( const std::exception& )
+    {
+        throw std::invalid_argument( "Invalid duration '" + str + "'" );
+    }
+    const std::string  unit = str.substr( pos );
+    unsigned long long us_per_unit;
+    if ( unit == "" || unit == "us" )
+    {
+        us_per_unit = 1;
+    }
+    else if ( unit == "ms" )
+    {
+        us_per_unit = 1000;
+    }
+    else if ( unit == "s" )
+    {
+        us_per_unit = 1000000;
+    }
+    else if ( unit == "m" )
+    {
+        us_per_unit = 60000000;
+    }
+    else
+    {
+        throw std::invalid_argument( "Invalid unit in duration '" + str + "'. Expected us, ms, s or m" );
+    }
+    const auto max_us = std::chrono::duration_cast<std::chrono::microseconds>( max_duration ).count();
+    if ( value > static_cast<unsigned long long>( max_us ) / us_per_unit )
+    {
+        return max_duration;
+    }
+    return std::chrono::microseconds( value * us_per_unit );
+}
 }
@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -23,6 +24,30 @@ std::string
 join_strings( const std::vector<std::string>& strings,
               std::string                     delim );
 
+// A JSON string, with quotes, backslashes and control characters escaped.
+// Control characters become \u00XX, which is all meric_summary has to unescape.
+std::string
+json_quote( const std::string& text );
+
+// Value of the environment variable SCOREP_METRIC_MERIC_PLUGIN_<name>, or `default_value`.
+// SCOREP_METRIC_MERIC_GPU_PLUGIN_<name> for the per-process GPU plugin.
+// Unlike scorep::environment_variable::get, this also works outside of a Score-P
+// measurement, e.g. in show_counters.
+std::string
+get_option( const std::string& name,
+            const std::string& default_value = "" );
+
+
+// Longest duration accepted as a time span, so that adding it to a time point cannot overflow
+constexpr std::chrono::hours max_duration( 24 * 365 * 10 );
+
+// Parse a duration like "500us", "20ms", "5s" or "2m". A plain number is
+// interpreted as microseconds. Longer durations than max_duration are clamped.
+// Throws std::invalid_argument on bad input, including negative numbers.
+std::chrono::microseconds
+parse_duration( const std::string& str );
+
+
 template <typename K, typename V>
 std::unordered_map<V, K>
 map_inverse( const std::unordered_map<K, V>& map )
@@ -0,0 +1,300 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Benchmarks for the plugin's own overhead. Results are printed as JSON.
+ *
+ * Usage: meric_plugin_bench [BACKEND...]
+ * The sampler sections run the measurement thread against the simulated backend, so
+ * they need no energy hardware. Additionally, the read latency of each given backend,
+ * e.g. "extlib rapl", is measured.
+ */
+#include "EnergyBackend.h"
+#include "MeasurementThread.h"
+#include "SampleTable.h"
+#include "SimBackend.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using namespace MericPlugin;
+using BenchClock = std::chrono::steady_clock;
+
+// Counts every heap allocation of the process, including the measurement thread's
+static std::atomic<std::uint64_t> num_allocations( 0 );
+
+void*
+operator new( std::size_t size )
+{
+    num_allocations.fetch_add( 1, std::memory_order_relaxed );
+    if ( void* ptr = std::malloc( size ? size : 1 ) )
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete( void* ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void
+operator delete( void* ptr, std::size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+// Same layout as SCOREP_MetricTimeValuePair, which the Score-P cursor fills
+struct CursorEntry
+{
+    std::uint64_t timestamp;
+    std::uint64_t value;
+};
+
+// Stands in for the Score-P cursor that get_all_values() writes to
+struct BenchCursor
+{
+    std::vector<CursorEntry> entries;
+
+    void
+    resize( std::size_t size )
+    {
+        entries.clear();
+        entries.reserve( size );
+    }
+
+    void
+    write( scorep::chrono::ticks timestamp, double value )
+    {
+        CursorEntry entry;
+        entry.timestamp = timestamp.count();
+        static_assert( sizeof( double ) == sizeof( std::uint64_t ), "" );
+        std::memcpy( &entry.value, &value, sizeof( double ) );
+        entries.push_back( entry );
+    }
+};
+
+
+static double
+seconds_since( BenchClock::time_point begin )
+{
+    return std::chrono::duration<double>( BenchClock::now() - begin ).count();
+}
+
+
+// Sample timestamps in ns of the steady clock, as the Score-P clock is not available
+static scorep::chrono::ticks
+steady_ticks()
+{
+    return scorep::chrono::ticks( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      BenchClock::now().time_since_epoch() )
+                                      .count() );
+}
+
+
+// Handles of a simulated RAPL domain with `num_metrics` counters
+static std::vector<Metric>
+sim_handles( std::size_t num_metrics )
+{
+    const unsigned int  rapl = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_RAPL;
+    std::vector<Metric> handles;
+    for ( std::size_t i = 0; i < num_metrics; ++i )
+    {
+        handles.emplace_back( Metric::Single(), rapl, rapl, "RAPL", i, "COUNTER_" + std::to_string( i ) );
+    }
+    return handles;
+}
+
+
+static std::unique_ptr<EnergyBackend>
+sim_backend( std::size_t num_metrics )
+{
+    const unsigned int rapl = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_RAPL;
+    SimBackend::Config config;
+    config.domains = { { "RAPL", unsigned( num_metrics ) } };
+    config.refresh = std::chrono::microseconds( 0 );
+    return std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) );
+}
+
+
+// Runs the sampler for `duration` on a simulated RAPL domain with `num_metrics` counters,
+// returns the allocations during the run
+static std::uint64_t
+run_sampler( MeasurementThread& measurement, std::size_t num_metrics, std::chrono::milliseconds duration )
+{
+    auto       handles     = sim_handles( num_metrics );
+    auto       backend     = sim_backend( num_metrics );
+    const auto allocations = num_allocations.load();
+    measurement.start( std::move( backend ), handles );
+    std::this_thread::sleep_for( duration );
+    // Only count the sampling itself, not the preparation of the readings at stop()
+    const auto allocated = num_allocations.load() - allocations;
+    measurement.stop();
+    return allocated;
+}
+
+
+// Cost of one sample, depending on the number of metrics. The sampler runs without pause.
+static void
+bench_sampling( std::size_t num_metrics, bool first )
+{
+    MeasurementThread measurement( std::chrono::microseconds( 0 ), {}, &steady_ticks );
+    const auto        allocations = run_sampler( measurement, num_metrics, std::chrono::milliseconds( 200 ) );
+    const auto&       samples     = measurement.samples();
+    const auto        elapsed_ns  = samples.size() > 1
+                                    ? double( samples.timestamp( samples.size() - 1 ).count()
+                                              - samples.timestamp( 0 ).count() )
+                                    : 0.;
+
+    std::cout << ( first ? "" : ",\n" )
+              << "    { \"metrics\": " << num_metrics
+              << ", \"samples\": " << samples.size()
+              << ", \"ns_per_sample\": " << ( samples.size() > 1 ? elapsed_ns / ( samples.size() - 1 ) : 0. )
+              << ", \"allocations_per_sample\": " << ( samples.size() ? double( allocations ) / samples.size() : 0. )
+              << ", \"bytes_per_sample\": " << ( samples.size() ? double( samples.bytes() ) / samples.size() : 0. )
+              << " }";
+}
+
+
+// Achieved against requested sampling interval, and the jitter of the single intervals
+static void
+bench_interval( std::chrono::microseconds interval, bool first )
+{
+    MeasurementThread measurement( interval, {}, &steady_ticks );
+    run_sampler( measurement, 10, std::chrono::milliseconds( 500 ) );
+    const auto& samples = measurement.samples();
+
+    std::vector<double> deviation_us;
+    double              sum_us = 0.;
+    for ( std::size_t row = 1; row < samples.size(); ++row )
+    {
+        const double delta_us = ( samples.timestamp( row ).count() - samples.timestamp( row - 1 ).count() ) / 1e3;
+        sum_us += delta_us;
+        deviation_us.push_back( std::abs( delta_us - interval.count() ) );
+    }
+    std::sort( deviation_us.begin(), deviation_us.end() );
+    const auto percentile = [ & ]( double p )
+    {
+        return deviation_us.empty() ? 0. : deviation_us[ std::size_t( p * ( deviation_us.size() - 1 ) ) ];
+    };
+
+    std::cout << ( first ? "" : ",\n" )
+              << "    { \"requested_us\": " << interval.count()
+              << ", \"samples\": " << samples.size()
+              << ", \"achieved_us\": " << ( deviation_us.empty() ? 0. : sum_us / deviation_us.size() )
+              << ", \"jitter_p50_us\": " << percentile( 0.5 )
+              << ", \"jitter_p90_us\": " << percentile( 0.9 )
+              << ", \"jitter_p99_us\": " << percentile( 0.99 )
+              << ", \"jitter_max_us\": " << percentile( 1. ) << " }";
+}
+
+
+// Time of MeasurementThread::stop(), which prepares the readings of all metrics, and of
+// draining them into cursors like get_all_values() does, after sampling for `duration`
+static void
+bench_finalization( std::size_t num_metrics, std::chrono::milliseconds duration, bool first )
+{
+    MeasurementThread measurement( std::chrono::microseconds( 0 ), {}, &steady_ticks );
+    auto              handles = sim_handles( num_metrics );
+    measurement.start( sim_backend( num_metrics ), handles );
+    std::this_thread::sleep_for( duration );
+
+    auto       begin       = BenchClock::now();
+    measurement.stop();
+    const auto stop        = seconds_since( begin );
+    const auto num_samples = measurement.samples().size();
+    measurement.release_samples();
+
+    begin = BenchClock::now();
+    BenchCursor cursor;
+    for ( auto& handle : handles )
+    {
+        write_readings( measurement.readings( handle ), cursor );
+    }
+    const auto drain = seconds_since( begin );
+
+    std::cout << ( first ? "" : ",\n" )
+              << "    { \"metrics\": " << num_metrics
+              << ", \"samples\": " << num_samples
+              << ", \"threads\": " << std::thread::hardware_concurrency()
+              << ", \"stop_s\": " << stop
+              << ", \"drain_s\": " << drain << " }";
+}
+
+
+// Latency of one backend read, with all domains enabled
+static void
+bench_backend_read( const std::string& name, bool first )
+{
+    std::cout << ( first ? "" : ",\n" ) << "    { \"backend\": " << json_quote( name );
+    try
+    {
+        auto          backend = make_backend( name, EnergyBackend::all_domain_ids() );
+        EnergyReading reading;
+        backend->read( reading );
+
+        const std::size_t num_reads = 10000;
+        const auto        begin     = BenchClock::now();
+        for ( std::size_t i = 0; i < num_reads; ++i )
+        {
+            backend->read( reading );
+        }
+        std::cout << ", \"reads\": " << num_reads
+                  << ", \"ns_per_read\": " << seconds_since( begin ) * 1e9 / num_reads << " }";
+    }
+    catch ( const std::exception& e )
+    {
+        std::cout << ", \"error\": " << json_quote( e.what() ) << " }";
+    }
+}
+
+
+int
+main( int argc, char** argv )
+{
+    std::cout << "{\n  \"sampling\": [\n";
+    bool first = true;
+    for ( std::size_t num_metrics : { 1, 10, 100, 1000 } )
+    {
+        bench_sampling( num_metrics, first );
+        first = false;
+    }
+    std::cout << "\n  ],\n  \"interval\": [\n";
+    first = true;
+    for ( int interval_us : { 10000, 1000, 100 } )
+    {
+        bench_interval( std::chrono::microseconds( interval_us ), first );
+        first = false;
+    }
+    std::cout << "\n  ],\n  \"finalization\": [\n";
+    first = true;
+    for ( int duration_ms : { 100, 1000 } )
+    {
+        bench_finalization( 50, std::chrono::milliseconds( duration_ms ), first );
+        first = false;
+    }
+    std::cout << "\n  ],\n  \"backend_read\": [\n";
+    for ( int arg = 1; arg < argc; ++arg )
+    {
+        bench_backend_read( argv[ arg ], arg == 1 );
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+    return 0;
+}
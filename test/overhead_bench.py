@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+"""
+Measure how much the plugin slows down an instrumented application.
+
+Every application runs with Score-P without any metric plugin, and with the plugin for
+each combination of sampling interval and domain set. The configurations are run
+interleaved, `--repeats` times each, so that drifts of the machine affect all of them
+alike. Reported is the slowdown against the run without plugin, with a 95 % confidence
+interval. By default, the plugin uses the simulated backend, so no energy hardware is
+needed.
+
+Example:
+  overhead_bench.py --plugin-dir build \\
+      --app "adv=mpirun -n 2 ./adv.x" --app "compute=./overhead_kernels.x compute 2000" \\
+      --intervals 100,1000,10000 --domain-sets "RAPL;RAPL,NVML" --repeats 10
+"""
+
+import argparse
+import json
+import math
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+# Two-sided 95 % quantiles of Student's t distribution, by degrees of freedom
+T_95 = [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042]
+
+
+def t_95(dof):
+    return T_95[dof - 1] if dof <= len(T_95) else 1.96
+
+
+def mean_ci(values):
+    """Mean and half width of the 95 % confidence interval"""
+    mean = statistics.mean(values)
+    if len(values) < 2:
+        return mean, float("nan")
+    return mean, t_95(len(values) - 1) * statistics.stdev(values) / math.sqrt(len(values))
+
+
+def slowdown_ci(runtimes, baseline):
+    """Ratio of the mean runtimes, with the confidence interval from error propagation"""
+    mean, ci = mean_ci(runtimes)
+    base_mean, base_ci = mean_ci(baseline)
+    ratio = mean / base_mean
+    return ratio, ratio * math.sqrt((ci / mean) ** 2 + (base_ci / base_mean) ** 2)
+
+
+def configurations(args):
+    yield {"name": "no_plugin", "env": {}}
+    for interval in args.intervals:
+        for domains in args.domain_sets:
+            metrics = ",".join(["%s:TOTAL" % domain for domain in domains.split(",")] + ["TOTAL:TOTAL"])
+            yield {
+                "name": "interval_%dus_%s" % (interval, domains.replace(",", "+")),
+                "interval_us": interval,
+                "domains": domains,
+                "env": {
+                    "SCOREP_METRIC_PLUGINS": "meric_plugin",
+                    "SCOREP_METRIC_MERIC_PLUGIN": metrics,
+                    "SCOREP_METRIC_MERIC_PLUGIN_INTERVAL_US": str(interval),
+                    "SCOREP_METRIC_MERIC_PLUGIN_DOMAINS": domains,
+                    "SCOREP_METRIC_MERIC_PLUGIN_BACKEND": args.backend,
+                    "SCOREP_METRIC_MERIC_PLUGIN_SIM_DOMAINS": args.sim_domains,
+                },
+            }
+
+
+def run(command, env, workdir):
+    """Wall time of one run, in seconds"""
+    experiment = tempfile.mkdtemp(prefix="scorep-overhead-", dir=workdir)
+    os.rmdir(experiment)  # Score-P refuses to write into an existing directory
+    env = dict(env, SCOREP_EXPERIMENT_DIRECTORY=experiment)
+    begin = time.perf_counter()
+    result = subprocess.run(command, shell=True, env=env, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    runtime = time.perf_counter() - begin
+    shutil.rmtree(experiment, ignore_errors=True)
+    if result.returncode != 0:
+        sys.exit("'%s' failed:\n%s" % (command, result.stderr.decode(errors="replace")))
+    return runtime
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--plugin-dir", required=True, help="directory of libmeric_plugin.so")
+    parser.add_argument("--app", action="append", required=True, metavar="NAME=COMMAND",
+                        help="instrumented application to run, can be given multiple times")
+    parser.add_argument("--intervals", default="100,1000,10000,50000",
+                        type=lambda s: [int(i) for i in s.split(",")], help="sampling intervals in us")
+    parser.add_argument("--domain-sets", default="RAPL;RAPL,NVML", type=lambda s: s.split(";"),
+                        help="semicolon separated list of SCOREP_METRIC_MERIC_PLUGIN_DOMAINS values")
+    parser.add_argument("--repeats", default=10, type=int)
+    parser.add_argument("--backend", default="sim")
+    parser.add_argument("--sim-domains", default="RAPL:4,NVML:2")
+    parser.add_argument("--tracing", default=1, type=int, help="value of SCOREP_ENABLE_TRACING")
+    parser.add_argument("--output", help="also write the results as JSON to this file")
+    args = parser.parse_args()
+
+    base_env = dict(os.environ)
+    base_env.pop("SCOREP_METRIC_PLUGINS", None)
+    base_env.update({
+        "LD_LIBRARY_PATH": os.path.abspath(args.plugin_dir) + ":" + os.environ.get("LD_LIBRARY_PATH", ""),
+        "SCOREP_ENABLE_PROFILING": "0",
+        "SCOREP_ENABLE_TRACING": str(args.tracing),
+    })
+    configs = list(configurations(args))
+    workdir = tempfile.mkdtemp(prefix="meric-overhead-")
+
+    results = []
+    for app in args.app:
+        name, command = app.split("=", 1)
+        runtimes = {config["name"]: [] for config in configs}
+        for repeat in range(args.repeats):
+            for config in configs:
+                runtimes[config["name"]].append(run(command, dict(base_env, **config["env"]), workdir))
+            print("%s: repeat %d/%d done" % (name, repeat + 1, args.repeats), file=sys.stderr)
+
+        baseline = runtimes["no_plugin"]
+        print("\n%s" % name)
+        print("%-32s %10s %10s %10s %10s" % ("configuration", "mean_s", "ci95_s", "slowdown", "ci95"))
+        for config in configs:
+            mean, ci = mean_ci(runtimes[config["name"]])
+            slowdown, slowdown_ci95 = slowdown_ci(runtimes[config["name"]], baseline)
+            print("%-32s %10.4f %10.4f %10.4f %10.4f" % (config["name"], mean, ci, slowdown, slowdown_ci95))
+            results.append({
+                "app": name,
+                "configuration": config["name"],
+                "interval_us": config.get("interval_us"),
+                "domains": config.get("domains"),
+                "runtimes_s": runtimes[config["name"]],
+                "mean_s": mean,
+                "ci95_s": ci,
+                "slowdown": slowdown,
+                "slowdown_ci95": slowdown_ci95,
+            })
+
+    shutil.rmtree(workdir, ignore_errors=True)
+    if args.output:
+        with open(args.output, "w") as output:
+            json.dump(results, output, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+/*
+ * Two small kernels for the application overhead benchmark:
+ *
+ *  overhead_kernels.x compute ITERATIONS   dependent floating point operations per thread
+ *  overhead_kernels.x memory ITERATIONS    stream triad over arrays larger than the caches
+ *
+ * Each iteration is one instrumented function call, so the kernels also show the
+ * interaction of the plugin with frequent Score-P events.
+ */
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COMPUTE_STEPS 100000
+#define MEMORY_ELEMENTS ( 1 << 24 )
+
+double
+compute_step( double x )
+{
+    double y = x;
+    for ( int i = 0; i < COMPUTE_STEPS; ++i )
+    {
+        y = y * 1.0000001 + 1e-9;
+    }
+    return y;
+}
+
+void
+memory_step( double* a, const double* b, const double* c, long n )
+{
+#pragma omp parallel for
+    for ( long i = 0; i < n; ++i )
+    {
+        a[ i ] = b[ i ] + 3. * c[ i ];
+    }
+}
+
+int
+main( int argc, char* argv[] )
+{
+    if ( argc != 3 )
+    {
+        fprintf( stderr, "Usage: %s compute|memory ITERATIONS\n", argv[ 0 ] );
+        return 1;
+    }
+    const long   iterations = atol( argv[ 2 ] );
+    const double begin      = omp_get_wtime();
+    double       check      = 0.;
+
+    if ( strcmp( argv[ 1 ], "compute" ) == 0 )
+    {
+#pragma omp parallel reduction(+:check)
+        {
+            double x = omp_get_thread_num();
+            for ( long it = 0; it < iterations; ++it )
+            {
+                x = compute_step( x );
+            }
+            check += x;
+        }
+    }
+    else if ( strcmp( argv[ 1 ], "memory" ) == 0 )
+    {
+        double* a = malloc( MEMORY_ELEMENTS * sizeof( double ) );
+        double* b = malloc( MEMORY_ELEMENTS * sizeof( double ) );
+        double* c = malloc( MEMORY_ELEMENTS * sizeof( double ) );
+#pragma omp parallel for
+        for ( long i = 0; i < MEMORY_ELEMENTS; ++i )
+        {
+            a[ i ] = 0.;
+            b[ i ] = 1.;
+            c[ i ] = 2.;
+        }
+        for ( long it = 0; it < iterations; ++it )
+        {
+            memory_step( a, b, c, MEMORY_ELEMENTS );
+        }
+        check = a[ MEMORY_ELEMENTS - 1 ];
+        free( a );
+        free( b );
+        free( c );
+    }
+    else
+    {
+        fprintf( stderr, "Unknown kernel %s\n", argv[ 1 ] );
+        return 1;
+    }
+
+    printf( "%s: %f s (check %g)\n", argv[ 1 ], omp_get_wtime() - begin, check );
+    return 0;
+}
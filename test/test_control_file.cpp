@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Check the parsing of the control file and that changes of the file reach the callback
+ */
+#include "ControlFile.h"
+#include "utils.h"
+#include "test_utils.h"
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+
+using namespace MericPlugin;
+using namespace MericPlugin::test;
+
+
+int
+main()
+{
+    // Settings that are not given are not changed
+    {
+        std::istringstream in( "# comment\n\ninterval=10ms\n" );
+        const auto         settings = ControlFile::parse( in );
+        CHECK( settings.has_interval );
+        CHECK( settings.interval.count() == 10000 );
+        CHECK( !settings.has_domains );
+        CHECK( !settings.has_burst );
+    }
+    {
+        std::istringstream in( "domains=RAPL,NVML\nburst=500us:2s\n" );
+        const auto         settings = ControlFile::parse( in );
+        CHECK( !settings.has_interval );
+        CHECK( settings.has_domains );
+        CHECK( settings.domains.size() == 2 && settings.domains[ 1 ] == "NVML" );
+        CHECK( settings.has_burst && settings.burst );
+        CHECK( settings.burst_interval.count() == 500 );
+        CHECK( settings.burst_duration.count() == 2000000 );
+    }
+    {
+        std::istringstream in( "domains=ALL\nburst=off\n" );
+        const auto         settings = ControlFile::parse( in );
+        CHECK( settings.has_domains && settings.domains.empty() );
+        CHECK( settings.has_burst && !settings.burst );
+    }
+    // Invalid lines are skipped
+    {
+        std::istringstream in( "interval=fast\nsamples=10\nburst=1ms\ninterval=0\nburst=0:1s\n" );
+        const auto         settings = ControlFile::parse( in );
+        CHECK( !settings.has_interval );
+        CHECK( !settings.has_domains );
+        CHECK( !settings.has_burst );
+    }
+    // Negative durations are rejected, and very long ones are clamped
+    {
+        std::istringstream in( "interval=-5ms\nburst=1ms:99999999999999m\n" );
+        const auto         settings = ControlFile::parse( in );
+        CHECK( !settings.has_interval );
+        CHECK( settings.has_burst && settings.burst_duration == max_duration );
+    }
+
+    // Writing and replacing the file both trigger the callback
+    {
+        const TempDir     temp( "meric_control" );
+        const std::string path = temp.path() + "/control";
+
+        // A file that exists already is applied at the start
+        std::ofstream( path ) << "interval=1ms\n";
+        std::atomic<int>  calls( 0 );
+        std::atomic<long> interval_us( 0 );
+        {
+            ControlFile control( path, [ & ]( const ControlFile::Settings& settings ){
+                    interval_us = settings.interval.count();
+                    calls++;
+                } );
+            CHECK( calls == 1 );
+            CHECK( interval_us == 1000 );
+
+            std::ofstream( path ) << "interval=2ms\n";
+            for ( int i = 0; i < 100 && calls < 2; ++i )
+            {
+                std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            }
+            CHECK( calls == 2 );
+            CHECK( interval_us == 2000 );
+
+            std::ofstream( path + ".new" ) << "interval=3ms\n";
+            CHECK( rename( ( path + ".new" ).c_str(), path.c_str() ) == 0 );
+            for ( int i = 0; i < 100 && calls < 3; ++i )
+            {
+                std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            }
+            CHECK( calls == 3 );
+            CHECK( interval_us == 3000 );
+        }
+    }
+    return 0;
+}
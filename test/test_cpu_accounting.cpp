@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Check the CPU time share of the traced processes against fake /proc and cgroup files
+ */
+#include "CpuAccounting.h"
+#include "Metric.h"
+#include "test_utils.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+
+using namespace MericPlugin;
+using namespace MericPlugin::test;
+
+
+// /proc/stat with `busy` ticks of user time and as many idle ticks
+static void
+write_node( const std::string& proc, unsigned long long busy )
+{
+    write_file( proc + "/stat", "cpu  " + std::to_string( busy ) + " 0 0 " + std::to_string( busy ) + " 0 0 0 0 0 0\ncpu0 0 0 0 0 0 0 0 0 0 0" );
+}
+
+
+// /proc/self/stat with a command name that contains spaces and parentheses
+static void
+write_process( const std::string& proc, unsigned long long utime, unsigned long long stime )
+{
+    write_file( proc + "/self/stat", "4242 (my (app) x) R 1 4242 4242 0 -1 4194304 100 0 0 0 "
+                + std::to_string( utime ) + " " + std::to_string( stime ) + " 0 0 20 0 1 0 100 0 0" );
+}
+
+
+int
+main()
+{
+    const TempDir     temp( "meric_cpu_accounting" );
+    const std::string root   = temp.path();
+    const std::string proc   = root + "/proc";
+    const std::string cgroup = root + "/cgroup";
+    mkdir( proc.c_str(), 0755 );
+    mkdir( ( proc + "/self" ).c_str(), 0755 );
+    mkdir( cgroup.c_str(), 0755 );
+    mkdir( ( cgroup + "/job" ).c_str(), 0755 );
+    const double ticks_per_second = sysconf( _SC_CLK_TCK );
+
+    // Process: a quarter of the busy time of the node
+    write_node( proc, 1000 );
+    write_process( proc, 100, 50 );
+    {
+        CpuAccounting accounting( CpuAccounting::Scope::process, proc, cgroup );
+        CHECK( accounting.scope() == CpuAccounting::Scope::process );
+        write_node( proc, 1400 );
+        write_process( proc, 170, 80 );
+        CHECK( std::fabs( accounting.share() - 0.25 ) < 1e-12 );
+
+        // Without progress of the node, the last share is kept
+        write_process( proc, 180, 80 );
+        CHECK( std::fabs( accounting.share() - 0.25 ) < 1e-12 );
+
+        // Clamped, the counters of the node and the process are not updated atomically
+        write_node( proc, 1410 );
+        write_process( proc, 280, 80 );
+        CHECK( accounting.share() == 1. );
+    }
+
+    // Without a cgroup v2 path, falls back to the process
+    write_file( proc + "/self/cgroup", "12:cpu,cpuacct:/job" );
+    {
+        CpuAccounting accounting( CpuAccounting::Scope::cgroup, proc, cgroup );
+        CHECK( accounting.scope() == CpuAccounting::Scope::process );
+    }
+
+    // Cgroup: half of the busy time of the node, counted in us
+    write_file( proc + "/self/cgroup", "0::/job" );
+    write_node( proc, 1000 );
+    write_file( cgroup + "/job/cpu.stat", "usage_usec 1000000\nuser_usec 800000\nsystem_usec 200000" );
+    {
+        CpuAccounting accounting( CpuAccounting::Scope::cgroup, proc, cgroup );
+        CHECK( accounting.scope() == CpuAccounting::Scope::cgroup );
+        write_node( proc, 1000 + 2 * ticks_per_second );
+        write_file( cgroup + "/job/cpu.stat", "usage_usec 2000000\nuser_usec 1800000\nsystem_usec 200000" );
+        CHECK( std::fabs( accounting.share() - 0.5 ) < 1e-9 );
+    }
+
+    bool thrown = false;
+    try
+    {
+        CpuAccounting accounting( CpuAccounting::Scope::process, root + "/missing", cgroup );
+    }
+    catch ( const std::runtime_error& )
+    {
+        thrown = true;
+    }
+    CHECK( thrown );
+
+    // The attributed metrics are distinct from the plain ones
+    const Metric plain( Metric::Single(), 1, 1, "RAPL", 2, "PCKG_0" );
+    const Metric self( Metric::Single(), 1, 1, "RAPL", 2, "PCKG_0", true );
+    const Metric total( Metric::DomainTotal(), 1, 1, "RAPL", true );
+    CHECK( self.name() == "RAPL:PCKG_0:SELF" );
+    CHECK( total.name() == "RAPL:TOTAL:SELF" );
+    CHECK( plain.id() != self.id() );
+    CHECK( !( plain == self ) );
+    return 0;
+}
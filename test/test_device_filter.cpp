@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Check the restriction of GPU domains to the devices of a process
+ */
+#include "DeviceFilter.h"
+#include "SimBackend.h"
+#include "test_utils.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+
+using namespace MericPlugin;
+
+
+static const unsigned int rapl = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_RAPL;
+static const unsigned int nvml = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_NVML;
+static const unsigned int rocm = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_ROCM;
+
+
+int
+main()
+{
+    CHECK( DeviceFilterBackend::counter_device( "GPU_12" ) == 12 );
+    CHECK( DeviceFilterBackend::counter_device( "COUNTER_0" ) == 0 );
+    CHECK( DeviceFilterBackend::counter_device( "TOTAL" ) == -1 );
+
+    // Devices from the environment
+    unsetenv( "ROCR_VISIBLE_DEVICES" );
+    unsetenv( "HIP_VISIBLE_DEVICES" );
+    setenv( "CUDA_VISIBLE_DEVICES", "1,3", 1 );
+    auto devices = DeviceFilterBackend::devices_from_environment( "" );
+    CHECK( devices.size() == 1 );
+    CHECK( devices.at( nvml ) == std::set<unsigned int>( { 1, 3 } ) );
+
+    setenv( "CUDA_VISIBLE_DEVICES", "GPU-8f1c2d3e", 1 );
+    CHECK( DeviceFilterBackend::devices_from_environment( "" ).empty() );
+
+    setenv( "HIP_VISIBLE_DEVICES", "2", 1 );
+    devices = DeviceFilterBackend::devices_from_environment( "" );
+    CHECK( devices.size() == 1 && devices.at( rocm ) == std::set<unsigned int>( { 2 } ) );
+
+    // Explicit list, and mapping by local rank
+    devices = DeviceFilterBackend::devices_from_environment( "0,2" );
+    CHECK( devices.at( nvml ) == std::set<unsigned int>( { 0, 2 } ) && devices.at( rocm ) == devices.at( nvml ) );
+    setenv( "SLURM_LOCALID", "1", 1 );
+    devices = DeviceFilterBackend::devices_from_environment( "0:0,1:2+3" );
+    CHECK( devices.at( nvml ) == std::set<unsigned int>( { 2, 3 } ) );
+    setenv( "SLURM_LOCALID", "5", 1 );
+    CHECK( DeviceFilterBackend::devices_from_environment( "0:0,1:2+3" ).empty() );
+
+    // Only the counters of the devices are available, and the totals only sum them up
+    SimBackend::Config config;
+    config.domains = { { "RAPL", 2 }, { "NVML", 4 } };
+    config.refresh = std::chrono::microseconds( 0 );
+    DeviceFilterBackend backend( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl, nvml }, config ) ),
+                                 { { nvml, { 1, 3 } } } );
+    const auto domains = backend.query_enabled_domains();
+    CHECK( domains.at( "NVML" ).counter_idx_by_name.size() == 2 );
+    CHECK( domains.at( "NVML" ).counter_idx_by_name.count( "COUNTER_3" ) == 1 );
+    CHECK( domains.at( "NVML" ).counter_idx_by_name.count( "COUNTER_0" ) == 0 );
+    CHECK( domains.at( "RAPL" ).counter_idx_by_name.size() == 2 );
+
+    EnergyReading begin, end, delta;
+    backend.read( begin );
+    for ( volatile int i = 0; i < 1000000; ++i )
+    {
+    }
+    backend.read( end );
+    backend.calc_energy_consumption( begin, end, delta );
+    const auto& gpu = delta.domain_data[ nvml ];
+    CHECK( gpu.energy_total > 0. );
+    CHECK( std::fabs( gpu.energy_total - gpu.energy_per_counter[ 1 ] - gpu.energy_per_counter[ 3 ] ) < 1e-9 );
+    CHECK( std::fabs( delta.energy_total - gpu.energy_total - delta.domain_data[ rapl ].energy_total ) < 1e-9 );
+    return 0;
+}
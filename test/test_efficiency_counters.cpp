@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Check the co-sampled CPU frequency against a fake cpufreq sysfs tree, from cycle counts
+ * where perf_event allows it, and the EFF metrics
+ */
+#include "EfficiencyCounters.h"
+#include "Metric.h"
+#include "test_utils.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+
+using namespace MericPlugin;
+using namespace MericPlugin::test;
+
+
+static void
+make_cpu( const std::string& root, unsigned int cpu, unsigned int socket, unsigned int khz )
+{
+    const std::string path = root + "/cpu" + std::to_string( cpu );
+    mkdir( path.c_str(), 0755 );
+    mkdir( ( path + "/cpufreq" ).c_str(), 0755 );
+    mkdir( ( path + "/topology" ).c_str(), 0755 );
+    write_file( path + "/cpufreq/scaling_cur_freq", std::to_string( khz ) );
+    write_file( path + "/topology/physical_package_id", std::to_string( socket ) );
+}
+
+
+int
+main()
+{
+    const TempDir     temp( "meric_efficiency" );
+    const std::string root = temp.path();
+    make_cpu( root, 0, 0, 2000000 );
+    make_cpu( root, 1, 0, 3000000 );
+    make_cpu( root, 2, 1, 1000000 );
+    make_cpu( root, 3, 1, 1000000 );
+    mkdir( ( root + "/cpufreq" ).c_str(), 0755 ); // Not a CPU
+    // An offline CPU is left out, one without cpufreq only has no frequency
+    make_cpu( root, 4, 1, 1000000 );
+    write_file( root + "/cpu4/online", "0" );
+    mkdir( ( root + "/cpu5" ).c_str(), 0755 );
+    mkdir( ( root + "/cpu5/topology" ).c_str(), 0755 );
+    write_file( root + "/cpu5/topology/physical_package_id", "2" );
+
+    EfficiencyCounters counters( root, false );
+    CHECK( counters.num_sockets() == 3 );
+    CHECK( !counters.counts_instructions() );
+
+    EfficiencySample sample;
+    counters.read( sample, 0., 0. );
+    write_file( root + "/cpu3/cpufreq/scaling_cur_freq", "3000000" );
+    counters.read( sample, 0.1, 10. );
+    CHECK( std::fabs( sample.values[ EfficiencySample::avg_MHz ] - 2250. ) < 1e-9 );
+    CHECK( sample.socket_MHz.size() == 3 );
+    CHECK( std::fabs( sample.socket_MHz[ 0 ] - 2500. ) < 1e-9 );
+    CHECK( std::fabs( sample.socket_MHz[ 1 ] - 2000. ) < 1e-9 );
+    CHECK( std::isnan( sample.socket_MHz[ 2 ] ) );
+    CHECK( std::isnan( sample.values[ EfficiencySample::J_per_Ginstr ] ) );
+
+    // The EFF metrics read the sample
+    const EnergyReading reading;
+    const SamplerHealth health;
+    const Metric        avg( Metric::Efficiency(), EfficiencySample::avg_MHz );
+    const Metric        socket( Metric::Efficiency(), EfficiencySample::num_values + 1 );
+    const Metric        missing( Metric::Efficiency(), EfficiencySample::num_values + 7 );
+    CHECK( avg.name() == "EFF:avg_MHz" && avg.unit() == "MHz" && !avg.isEnergy() );
+    CHECK( socket.name() == "EFF:avg_MHz_1" );
+    CHECK( avg.id() != socket.id() );
+    CHECK( std::fabs( avg.read( reading, health, sample ) - 2250. ) < 1e-9 );
+    CHECK( std::fabs( socket.read( reading, health, sample ) - 2000. ) < 1e-9 );
+    CHECK( std::isnan( missing.read( reading, health, sample ) ) );
+    CHECK( Metric( Metric::Efficiency(), EfficiencySample::J_per_Ginstr ).unit() == "J/Ginstr" );
+
+    // With cycle counts, the frequency is the average over the interval of the busy CPU
+    EfficiencyCounters system;
+    if ( system.counts_instructions() )
+    {
+        system.read( sample, 0., 0. );
+        const auto begin = std::chrono::steady_clock::now();
+        while ( std::chrono::steady_clock::now() - begin < std::chrono::milliseconds( 100 ) )
+        {
+        }
+        system.read( sample, std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count(), 1. );
+        CHECK( sample.values[ EfficiencySample::avg_MHz ] > 0. );
+        CHECK( sample.socket_MHz.size() == system.num_sockets() );
+        CHECK( sample.values[ EfficiencySample::IPC ] > 0. );
+    }
+    else
+    {
+        std::cout << "No perf_event access, skipping the cycle counts" << std::endl;
+    }
+    return 0;
+}
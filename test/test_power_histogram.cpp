@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Check the time-weighted power histogram
+ */
+#include "PowerHistogram.h"
+#include "test_utils.h"
+
+#include <cmath>
+#include <iostream>
+
+
+using namespace MericPlugin;
+
+
+int
+main()
+{
+    // Every value lies within the bounds of its bucket, which are at most 1/32 apart
+    for ( double power : { 0.001, 0.3, 1., 42.5, 250., 251., 1000., 123456. } )
+    {
+        const auto bucket = PowerHistogram::bucket( power );
+        CHECK( PowerHistogram::lower_bound( bucket ) <= power );
+        CHECK( PowerHistogram::upper_bound( bucket ) > power );
+        CHECK( PowerHistogram::upper_bound( bucket ) - PowerHistogram::lower_bound( bucket ) <= power / 32. );
+        CHECK( PowerHistogram::upper_bound( bucket ) == PowerHistogram::lower_bound( bucket + 1 ) );
+    }
+    CHECK( PowerHistogram::bucket( -5. ) == 0 );
+    CHECK( PowerHistogram::bucket( NAN ) == 0 );
+    CHECK( PowerHistogram::bucket( 1e9 ) == PowerHistogram::num_buckets - 1 );
+    CHECK( PowerHistogram::bucket( INFINITY ) == PowerHistogram::num_buckets - 1 );
+
+    // 90 s at 100 W, 9 s at 300 W, 1 s at 500 W
+    PowerHistogram histogram;
+    for ( int i = 0; i < 900; ++i )
+    {
+        histogram.add( 100., 0.1 );
+    }
+    histogram.add( 300., 9. );
+    histogram.add( 500., 1. );
+    CHECK( std::fabs( histogram.total() - 100. ) < 1e-9 );
+    CHECK( std::fabs( histogram.share_above( 250. ) - 0.1 ) < 1e-9 );
+    CHECK( std::fabs( histogram.share_above( 400. ) - 0.01 ) < 1e-9 );
+    CHECK( histogram.percentile( 0.5 ) >= 100. && histogram.percentile( 0.5 ) <= 100. * ( 1. + 1. / 16. ) );
+    CHECK( histogram.percentile( 0.95 ) >= 300. && histogram.percentile( 0.95 ) <= 300. * ( 1. + 1. / 16. ) );
+    CHECK( histogram.percentile( 1. ) >= 500. && histogram.percentile( 1. ) <= 500. * ( 1. + 1. / 16. ) );
+
+    PowerHistogram empty;
+    CHECK( empty.share_above( 1. ) == 0. );
+    CHECK( empty.percentile( 0.5 ) == 0. );
+    return 0;
+}
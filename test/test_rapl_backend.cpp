@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Check the powercap RAPL backend against a fake sysfs tree
+ */
+#include "RaplBackend.h"
+#include "test_utils.h"
+
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+
+using namespace MericPlugin;
+using namespace MericPlugin::test;
+
+
+static void
+make_zone( const std::string& root, const std::string& dir, const std::string& name, unsigned long long energy_uj )
+{
+    mkdir( ( root + "/" + dir ).c_str(), 0755 );
+    write_file( root + "/" + dir + "/name", name );
+    write_file( root + "/" + dir + "/max_energy_range_uj", "1000000000" );
+    write_file( root + "/" + dir + "/energy_uj", std::to_string( energy_uj ) );
+}
+
+
+int
+main()
+{
+    const TempDir     temp( "meric_rapl" );
+    const std::string root = temp.path();
+
+    make_zone( root, "intel-rapl:0", "package-0", 500000000 );
+    make_zone( root, "intel-rapl:0:0", "dram", 1000000 );
+    make_zone( root, "intel-rapl:0:1", "core", 2000000 );
+    make_zone( root, "intel-rapl:1", "package-1", 999000000 );
+    write_file( root + "/intel-rapl:0/constraint_0_max_power_uw", "250000000" );
+
+    const unsigned int rapl = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_RAPL;
+    RaplBackend        backend( { rapl }, root );
+
+    const auto domains = backend.query_enabled_domains();
+    CHECK( domains.size() == 1 );
+    const Domain& domain = domains.at( "RAPL" );
+    CHECK( domain.counter_idx_by_name.size() == 4 );
+    CHECK( domain.counter_idx_by_name.count( "PCKG_0" ) == 1 );
+    CHECK( domain.counter_idx_by_name.count( "PCKG_1" ) == 1 );
+    CHECK( domain.counter_idx_by_name.count( "DRAM_0" ) == 1 );
+    CHECK( domain.counter_idx_by_name.count( "CORE_0" ) == 1 );
+
+    // 1000 J wrap in 4 s at 250 W, or in 2 s at the assumed 500 W of the zones without a limit
+    CHECK( backend.max_safe_interval() == std::chrono::seconds( 2 ) );
+    CHECK( RaplBackend::max_safe_interval( root ) == std::chrono::seconds( 2 ) );
+    CHECK( RaplBackend::max_safe_interval( root + "/missing" ).count() == 0 );
+
+    EnergyReading begin, end, delta;
+    backend.read( begin );
+
+    // package-1 wraps around at max_energy_range_uj
+    write_file( root + "/intel-rapl:0/energy_uj", "510000000" );
+    write_file( root + "/intel-rapl:0:0/energy_uj", "3000000" );
+    write_file( root + "/intel-rapl:0:1/energy_uj", "2500000" );
+    write_file( root + "/intel-rapl:1/energy_uj", "4000000" );
+    backend.read( end );
+    backend.calc_energy_consumption( begin, end, delta );
+
+    const auto& counters = delta.domain_data[ domain.idx ].energy_per_counter;
+    CHECK( std::fabs( counters[ domain.counter_idx_by_name.at( "PCKG_0" ) ] - 10. ) < 1e-9 );
+    CHECK( std::fabs( counters[ domain.counter_idx_by_name.at( "DRAM_0" ) ] - 2. ) < 1e-9 );
+    CHECK( std::fabs( counters[ domain.counter_idx_by_name.at( "CORE_0" ) ] - 0.5 ) < 1e-9 );
+    CHECK( std::fabs( counters[ domain.counter_idx_by_name.at( "PCKG_1" ) ] - 5. ) < 1e-9 );
+    // Package and DRAM, but not the core zone which is part of the package
+    CHECK( std::fabs( delta.domain_data[ domain.idx ].energy_total - 17. ) < 1e-9 );
+    CHECK( std::fabs( delta.energy_total - 17. ) < 1e-9 );
+
+    // Without RAPL requested, nothing is enabled
+    CHECK( RaplBackend( {}, root ).query_enabled_domains().empty() );
+
+    // Zones per die, and a platform zone that is not part of a package
+    {
+        const std::string dies = root + "/dies";
+        mkdir( dies.c_str(), 0755 );
+        make_zone( dies, "intel-rapl:0", "package-0-die-0", 0 );
+        make_zone( dies, "intel-rapl:1", "package-0-die-1", 0 );
+        make_zone( dies, "intel-rapl:1:0", "dram", 0 );
+        make_zone( dies, "intel-rapl:2", "psys", 0 );
+        RaplBackend dies_backend( { rapl }, dies );
+        const auto  names = dies_backend.query_enabled_domains().at( "RAPL" ).counter_idx_by_name;
+        CHECK( names.size() == 4 );
+        CHECK( names.count( "PCKG_0_DIE_0" ) == 1 );
+        CHECK( names.count( "PCKG_0_DIE_1" ) == 1 );
+        CHECK( names.count( "DRAM_0_DIE_1" ) == 1 );
+        CHECK( names.count( "PSYS" ) == 1 );
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Record the readings of the simulated backend and replay them
+ */
+#include "Recording.h"
+#include "SimBackend.h"
+#include "Watchdog.h"
+#include "test_utils.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+using namespace MericPlugin;
+using namespace MericPlugin::test;
+
+static const unsigned int rapl = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_RAPL;
+static const unsigned int nvml = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_NVML;
+
+
+int
+main()
+{
+    const TempDir     temp( "meric_recording" );
+    const std::string path = temp.path() + "/recording.bin";
+
+    SimBackend::Config config;
+    config.domains = { { "RAPL", 3 }, { "NVML", 2 } };
+    config.refresh = std::chrono::microseconds( 0 );
+
+    std::vector<EnergyReading> recorded( 20 );
+    {
+        std::unique_ptr<EnergyBackend> sim( new SimBackend( { rapl, nvml }, config ) );
+        RecordingBackend               recording( std::move( sim ), path );
+        for ( auto& reading : recorded )
+        {
+            recording.read( reading );
+            std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+        }
+    }
+
+    // As fast as possible: one record per read, identical values
+    {
+        ReplayBackend replay( { rapl, nvml }, path, 0. );
+        CHECK( replay.num_records() == recorded.size() );
+        const auto domains = replay.query_enabled_domains();
+        CHECK( domains.size() == 2 );
+        CHECK( domains.at( "RAPL" ).counter_idx_by_name.at( "COUNTER_2" ) == 2 );
+
+        EnergyReading reading;
+        for ( const auto& expected : recorded )
+        {
+            replay.read( reading );
+            CHECK( reading.energy_total == expected.energy_total );
+            for ( unsigned int domain : { rapl, nvml } )
+            {
+                CHECK( reading.domain_data[ domain ].energy_total == expected.domain_data[ domain ].energy_total );
+                CHECK( reading.domain_data[ domain ].energy_per_counter == expected.domain_data[ domain ].energy_per_counter );
+            }
+        }
+        // After the end, the last reading is repeated
+        replay.read( reading );
+        CHECK( reading.energy_total == recorded.back().energy_total );
+    }
+
+    // Only requested domains are replayed
+    {
+        ReplayBackend replay( { nvml }, path, 0. );
+        CHECK( replay.query_enabled_domains().size() == 1 );
+        EnergyReading reading;
+        replay.read( reading );
+        CHECK( reading.energy_total == recorded.front().domain_data[ nvml ].energy_total );
+    }
+
+    // At recorded speed, the first read returns the first record
+    {
+        ReplayBackend replay( { rapl, nvml }, path, 1. );
+        EnergyReading reading;
+        replay.read( reading );
+        CHECK( reading.energy_total == recorded.front().energy_total );
+    }
+
+    // With the watchdog inside the recording, only the reads of the sampler are recorded
+    {
+        config.wrap_j = 0.5;
+        {
+            RecordingBackend recording( guard_against_wraps( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ),
+                                                             std::chrono::milliseconds( 100 ) ),
+                                        path );
+            EnergyReading reading;
+            recording.read( reading );
+            std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+            recording.read( reading );
+        }
+        config.wrap_j = 0.;
+        ReplayBackend replay( { rapl }, path, 0. );
+        CHECK( replay.num_records() == 2 );
+    }
+    return 0;
+}
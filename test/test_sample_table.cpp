@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Check the sample table, and its resampling onto a uniform grid
+ */
+#include "SampleTable.h"
+#include "test_utils.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+
+using namespace MericPlugin;
+
+
+int
+main()
+{
+    // Two energy metrics and one held metric, at jittered times
+    SampleTable table;
+    table.reset( 3 );
+    const std::vector<std::uint64_t> times = { 100, 205, 290, 410, 500, 500, 730 };
+    double                           total[ 2 ] = { 0., 0. };
+    for ( std::size_t i = 0; i < times.size(); ++i )
+    {
+        const double row[ 3 ] = { 1. + i, 0.5 * i, double( i ) };
+        table.append( scorep::chrono::ticks( times[ i ] ), row );
+        total[ 0 ] += row[ 0 ];
+        total[ 1 ] += row[ 1 ];
+    }
+    CHECK( table.size() == times.size() );
+    CHECK( table.value( 3, 0 ) == 4. );
+
+    std::vector<double> column( table.size() );
+    table.copy_column( 2, column.data() );
+    CHECK( column[ 6 ] == 6. );
+
+    const auto columns = table.materialize( 2 );
+    CHECK( columns.size() == 3 );
+    CHECK( columns[ 1 ][ 2 ].first.count() == 290 );
+
+    // The grid has a step of 50 ticks, with points on 25 + k * 50
+    const auto resampled = table.resample( 25., 50., { 2 } );
+    CHECK( resampled.size() > 10 );
+    double resampled_total[ 2 ] = { 0., 0. };
+    for ( std::size_t row = 0; row < resampled.size(); ++row )
+    {
+        CHECK( ( resampled.timestamp( row ).count() - 25 ) % 50 == 0 );
+        if ( row > 0 )
+        {
+            CHECK( resampled.timestamp( row ).count() - resampled.timestamp( row - 1 ).count() == 50 );
+        }
+        resampled_total[ 0 ] += resampled.value( row, 0 );
+        resampled_total[ 1 ] += resampled.value( row, 1 );
+    }
+    // Energy is conserved, the first sample is assumed to start at 100 - 105
+    CHECK( std::fabs( resampled_total[ 0 ] - total[ 0 ] ) < 1e-9 );
+    CHECK( std::fabs( resampled_total[ 1 ] - total[ 1 ] ) < 1e-9 );
+    CHECK( resampled.timestamp( 0 ).count() == 25 );
+    CHECK( resampled.timestamp( resampled.size() - 1 ).count() == 775 );
+
+    // The interval ( 525, 575 ] lies within the last raw interval ( 500, 730 ]
+    CHECK( std::fabs( resampled.value( 11, 0 ) - 7. * 50. / 230. ) < 1e-9 );
+    // Held metrics keep the latest value
+    CHECK( resampled.value( resampled.size() - 1, 2 ) == 6. );
+
+    // Too few samples
+    SampleTable single;
+    single.reset( 1 );
+    const double value = 1.;
+    single.append( scorep::chrono::ticks( 10 ), &value );
+    CHECK( single.resample( 0., 10., {} ).size() == 0 );
+
+    // Timestamps of a 64-bit clock far from zero map without losing the low bits
+    {
+        SampleTable         mapped;
+        const std::uint64_t origin = ( std::uint64_t( 1 ) << 62 ) + 3;
+        mapped.reset( 1 );
+        mapped.append( scorep::chrono::ticks( origin - 7 ), &value );
+        mapped.append( scorep::chrono::ticks( origin + 1001 ), &value );
+        mapped.map_timestamps( origin, 1000000, 0.5 );
+        CHECK( mapped.timestamp( 0 ).count() == 1000000 - 4 );
+        CHECK( mapped.timestamp( 1 ).count() == 1000000 + 501 );
+    }
+    return 0;
+}
@@ -0,0 +1,243 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Write the samples of a simulated measurement to a side-car file and read them back
+ */
+#include "MeasurementThread.h"
+#include "SidecarWriter.h"
+#include "SimBackend.h"
+#include "meric_sidecar.h"
+#include "test_utils.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using namespace MericPlugin;
+using namespace MericPlugin::test;
+
+static const unsigned int rapl = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_RAPL;
+
+
+// The Score-P clock is not available outside a measurement
+static scorep::chrono::ticks
+steady_ticks()
+{
+    return scorep::chrono::ticks( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      std::chrono::steady_clock::now().time_since_epoch() )
+                                      .count() );
+}
+
+
+// Equal, including NaN
+static bool
+same( double a, double b )
+{
+    return std::memcmp( &a, &b, sizeof( double ) ) == 0;
+}
+
+
+// A side-car file of an energy and a latency metric, laid out like write_sidecar() does,
+// with a calibration of one ns per tick
+static std::vector<unsigned char>
+raw_sidecar( const std::vector<std::uint64_t>& timestamps, const std::vector<double>& energy, const std::vector<double>& latency )
+{
+    const auto align_up = []( std::uint64_t offset ){
+            return ( offset + 63 ) & ~std::uint64_t( 63 );
+        };
+    SidecarFormat::Header header;
+    std::memset( &header, 0, sizeof( header ) );
+    std::memcpy( header.magic, SidecarFormat::magic, sizeof( header.magic ) );
+    header.version                      = SidecarFormat::version;
+    header.num_metrics                  = 2;
+    header.num_samples                  = timestamps.size();
+    header.metrics_offset               = align_up( sizeof( header ) );
+    header.timestamps_offset            = align_up( header.metrics_offset + 2 * sizeof( SidecarFormat::MetricEntry ) );
+    header.values_offset                = align_up( header.timestamps_offset + timestamps.size() * sizeof( std::uint64_t ) );
+    header.column_stride                = align_up( timestamps.size() * sizeof( double ) );
+    header.calibration_ticks[ 1 ]       = 1000000000;
+    header.calibration_realtime_ns[ 1 ] = 1000000000;
+
+    SidecarFormat::MetricEntry entries[ 2 ];
+    std::memset( entries, 0, sizeof( entries ) );
+    std::strcpy( entries[ 0 ].name, "TOTAL:TOTAL" );
+    std::strcpy( entries[ 0 ].unit, "J" );
+    std::strcpy( entries[ 1 ].name, "PLUGIN:read_latency" );
+    std::strcpy( entries[ 1 ].unit, "s" );
+
+    std::vector<unsigned char> image( header.values_offset + 2 * header.column_stride, 0 );
+    std::memcpy( image.data(), &header, sizeof( header ) );
+    std::memcpy( image.data() + header.metrics_offset, entries, sizeof( entries ) );
+    std::memcpy( image.data() + header.timestamps_offset, timestamps.data(), timestamps.size() * sizeof( std::uint64_t ) );
+    std::memcpy( image.data() + header.values_offset, energy.data(), energy.size() * sizeof( double ) );
+    std::memcpy( image.data() + header.values_offset + header.column_stride, latency.data(), latency.size() * sizeof( double ) );
+    return image;
+}
+
+
+static void
+write_image( const std::string& path, const std::vector<unsigned char>& image )
+{
+    std::ofstream( path, std::ios::binary ).write( reinterpret_cast<const char*>( image.data() ), image.size() );
+}
+
+
+// Whether the reader rejects the image with its header changed by `patch`
+static bool
+rejected( const std::string& path, std::vector<unsigned char> image, void ( *patch )( SidecarFormat::Header& ) )
+{
+    SidecarFormat::Header header;
+    std::memcpy( &header, image.data(), sizeof( header ) );
+    patch( header );
+    std::memcpy( image.data(), &header, sizeof( header ) );
+    write_image( path, image );
+    try
+    {
+        SidecarReader reader( path );
+    }
+    catch ( const std::runtime_error& )
+    {
+        return true;
+    }
+    return false;
+}
+
+
+int
+main()
+{
+    SimBackend::Config config;
+    config.domains = { { "RAPL", 2 } };
+    config.power_w = 100.;
+
+    std::vector<Metric> handles;
+    handles.emplace_back( Metric::Total() );
+    handles.emplace_back( Metric::DomainTotal(), rapl, rapl, "RAPL" );
+    handles.emplace_back( Metric::Plugin(), SamplerHealth::read_latency );
+
+    // The RAPL domain is masked halfway, so its column has NaN at the end
+    MeasurementThread measurement( std::chrono::microseconds( 1000 ), {}, &steady_ticks );
+    measurement.start( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ), handles );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 30 ) );
+    std::vector<bool> disabled( rapl + 1, false );
+    disabled[ rapl ] = true;
+    measurement.mask_domains( disabled );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 30 ) );
+    measurement.stop();
+
+    const TempDir     temp( "meric_sidecar" );
+    const std::string path = temp.path() + "/meric_node01.sidecar";
+    write_sidecar( path, "node01", measurement );
+
+    const SampleTable&  table = measurement.samples();
+    const SidecarReader reader( path );
+    CHECK( table.size() > 2 );
+    CHECK( reader.hostname() == "node01" );
+    CHECK( reader.num_metrics() == handles.size() );
+    CHECK( reader.num_samples() == table.size() );
+    for ( std::size_t metric = 0; metric < handles.size(); ++metric )
+    {
+        CHECK( reader.metric_names()[ metric ] == handles[ metric ].name() );
+        CHECK( reader.unit( metric ) == handles[ metric ].unit() );
+        CHECK( reader.find_metric( handles[ metric ].name() ) == long( metric ) );
+    }
+    CHECK( reader.find_metric( "RAPL:COUNTER_7" ) == -1 );
+
+    const auto timestamps = reader.timestamps();
+    for ( std::size_t row = 0; row < table.size(); ++row )
+    {
+        CHECK( timestamps[ row ] == std::uint64_t( table.timestamp( row ).count() ) );
+        for ( std::size_t metric = 0; metric < handles.size(); ++metric )
+        {
+            CHECK( same( reader.values( metric )[ row ], table.value( row, metric ) ) );
+        }
+    }
+    CHECK( std::isnan( reader.values( 1 )[ table.size() - 1 ] ) );
+    CHECK( std::fabs( reader.to_realtime_seconds( measurement.start_clock().ticks.count() )
+                      - measurement.start_clock().realtime_ns * 1e-9 ) < 1e-6 );
+
+    // The windows sum up the energy without the NaN, and average the other metrics
+    const auto all_stats = interval_stats( reader, 0.01, 2 );
+    CHECK( all_stats.size() == handles.size() );
+    for ( std::size_t metric = 0; metric < 2; ++metric )
+    {
+        double      energy  = 0.;
+        std::size_t samples = 0;
+        for ( double value : reader.values( metric ) )
+        {
+            energy  += std::isnan( value ) ? 0. : value;
+            samples += !std::isnan( value );
+        }
+        double      window_energy  = 0.;
+        std::size_t window_samples = 0;
+        for ( const auto& s : all_stats[ metric ] )
+        {
+            CHECK( std::isnan( s.mean_value ) && std::isnan( s.peak_value ) );
+            window_energy  += s.energy_j;
+            window_samples += s.samples;
+        }
+        CHECK( energy > 0. );
+        CHECK( std::fabs( window_energy - energy ) < 1e-9 * energy );
+        CHECK( window_samples == samples );
+    }
+    for ( const auto& s : all_stats[ 2 ] )
+    {
+        CHECK( std::isnan( s.energy_j ) && std::isnan( s.mean_power_w ) && std::isnan( s.peak_power_w ) );
+        CHECK( s.samples == 0 || ( s.mean_value >= 0. && s.peak_value >= s.mean_value ) );
+    }
+
+    // 10 J every 0.1 s, and a sample stamped before the first one, which has no window
+    std::vector<std::uint64_t> stamps;
+    for ( std::uint64_t i = 0; i < 16; ++i )
+    {
+        stamps.push_back( 1000000000 + i * 100000000 );
+    }
+    stamps.push_back( 0 );
+    const std::vector<double>        energy( stamps.size(), 10. );
+    const std::vector<double>        latency( stamps.size(), 1e-3 );
+    const std::vector<unsigned char> image    = raw_sidecar( stamps, energy, latency );
+    const std::string                raw_path = temp.path() + "/raw.sidecar";
+    write_image( raw_path, image );
+    {
+        const SidecarReader raw( raw_path );
+        CHECK( raw.num_samples() == stamps.size() && raw.unit( 1 ) == "s" );
+        const auto stats = interval_stats( raw, 0, 0.95 );
+        CHECK( stats.size() == 2 );
+        CHECK( stats[ 0 ].samples == 10 && stats[ 1 ].samples == 6 );
+        CHECK( std::fabs( stats[ 1 ].energy_j - 60. ) < 1e-9 );
+        // The last window only covers 0.6 s, which does not lower its mean power
+        CHECK( std::fabs( stats[ 0 ].mean_power_w - 100. ) < 1e-6 );
+        CHECK( std::fabs( stats[ 1 ].mean_power_w - 100. ) < 1e-6 );
+    }
+
+    // Headers whose sizes are out of the file, also when they wrap around, or misaligned
+    CHECK( rejected( raw_path, image, []( SidecarFormat::Header& header ){
+            header.num_samples = std::uint64_t( 1 ) << 61;
+        } ) );
+    CHECK( rejected( raw_path, image, []( SidecarFormat::Header& header ){
+            header.metrics_offset += 4;
+        } ) );
+    CHECK( rejected( raw_path, image, []( SidecarFormat::Header& header ){
+            header.timestamps_offset = ~std::uint64_t( 7 );
+        } ) );
+    CHECK( rejected( raw_path, image, []( SidecarFormat::Header& header ){
+            header.column_stride = ~std::uint64_t( 7 );
+        } ) );
+    CHECK( rejected( raw_path, image, []( SidecarFormat::Header& header ){
+            header.column_stride = 8;
+        } ) );
+    CHECK( !rejected( raw_path, image, []( SidecarFormat::Header& ){} ) );
+    return 0;
+}
@@ -0,0 +1,472 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Check the simulated backend, and run the sampler with it
+ */
+#include "MeasurementThread.h"
+#include "SimBackend.h"
+#include "Watchdog.h"
+#include "test_utils.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+
+using namespace MericPlugin;
+
+
+static const unsigned int rapl = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_RAPL;
+static const unsigned int nvml = ExtlibEnergy::Domains::EXTLIB_ENERGY_DOMAIN_NVML;
+
+
+// The Score-P clock is not available outside a measurement
+static scorep::chrono::ticks
+steady_ticks()
+{
+    return scorep::chrono::ticks( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      std::chrono::steady_clock::now().time_since_epoch() )
+                                      .count() );
+}
+
+
+// Simulated time of the backends. Every read advances it by `sim_step_us`, and the
+// tests can advance it themselves, so the energy does not depend on the scheduling.
+static std::atomic<std::int64_t>  sim_time_us( 0 );
+static std::atomic<std::int64_t>  sim_step_us( 1000 );
+static std::atomic<std::uint64_t> sim_reads( 0 );
+
+static std::chrono::steady_clock::time_point
+sim_clock()
+{
+    sim_reads++;
+    return std::chrono::steady_clock::time_point( std::chrono::microseconds( sim_time_us += sim_step_us ) );
+}
+
+
+// Power of the 4 RAPL counters with the constant profile
+static double
+rapl_power( const SimBackend::Config& config )
+{
+    const SimBackend backend( { rapl }, config );
+    double           power = 0.;
+    for ( unsigned int counter = 0; counter < 4; ++counter )
+    {
+        power += backend.energy( rapl, counter, 1. );
+    }
+    return power;
+}
+
+
+int
+main()
+{
+    SimBackend::Config config;
+    config.domains = { { "RAPL", 4 }, { "NVML", 2 } };
+    config.power_w = 100.;
+    config.seed    = 42;
+    config.clock   = &sim_clock;
+
+    // Only requested domains are enabled
+    {
+        SimBackend backend( { rapl }, config );
+        const auto domains = backend.query_enabled_domains();
+        CHECK( domains.size() == 1 );
+        CHECK( domains.at( "RAPL" ).counter_idx_by_name.size() == 4 );
+        CHECK( domains.at( "RAPL" ).counter_idx_by_name.count( "COUNTER_3" ) == 1 );
+    }
+
+    // Reproducible for a seed, for every profile
+    for ( auto profile : { SimBackend::Profile::constant, SimBackend::Profile::sine, SimBackend::Profile::square } )
+    {
+        config.profile = profile;
+        SimBackend a( { rapl, nvml }, config );
+        SimBackend b( { rapl, nvml }, config );
+        CHECK( a.energy( nvml, 1, 2.5 ) == b.energy( nvml, 1, 2.5 ) );
+        CHECK( a.energy( rapl, 0, 0. ) == 0. );
+        // The mean power over whole periods is the scaled base power, in [0.5, 1.5) * power_w
+        const double mean_power = a.energy( rapl, 2, 10. ) / 10.;
+        CHECK( mean_power >= 50. && mean_power < 150. );
+        config.seed = 43;
+        SimBackend c( { rapl, nvml }, config );
+        config.seed = 42;
+        CHECK( a.energy( rapl, 0, 1. ) != c.energy( rapl, 0, 1. ) );
+    }
+    config.profile = SimBackend::Profile::constant;
+
+    // Counters only change at the refresh granularity
+    {
+        config.refresh = std::chrono::seconds( 10 );
+        SimBackend    backend( { rapl }, config );
+        EnergyReading begin, end, delta;
+        backend.read( begin );
+        backend.read( end );
+        backend.calc_energy_consumption( begin, end, delta );
+        CHECK( delta.energy_total == 0. );
+        config.refresh = std::chrono::microseconds( 0 );
+    }
+
+    // Counters wrap at wrap_j, but the readings keep accumulating
+    {
+        config.wrap_j = 0.5;
+        SimBackend    backend( { rapl }, config );
+        EnergyReading reading;
+        for ( int i = 0; i < 100; ++i )
+        {
+            backend.read( reading );
+        }
+        CHECK( std::fabs( reading.domain_data[ rapl ].energy_per_counter[ 0 ] - backend.energy( rapl, 0, 0.1 ) ) < 1e-9 );
+        CHECK( reading.domain_data[ rapl ].energy_per_counter[ 0 ] > 2 * config.wrap_j );
+
+        // Reads far apart miss wraparounds, unless the watchdog reads in between
+        sim_step_us         = 0;
+        const auto interval = std::chrono::milliseconds( 100 );
+        const auto safe     = backend.max_safe_interval();
+        CHECK( safe < interval );
+        const double  power = rapl_power( config );
+        EnergyReading begin, end, delta;
+        backend.read( begin );
+        sim_time_us += interval.count() * 1000;
+        backend.read( end );
+        backend.calc_energy_consumption( begin, end, delta );
+        CHECK( delta.energy_total < power * 0.1 - config.wrap_j );
+
+        auto guarded = guard_against_wraps( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ), interval );
+        CHECK( guarded->max_safe_interval().count() == 0 );
+        guarded->read( begin );
+        // Advance in steps below the safe interval, and wait for a read of the watchdog after each
+        std::int64_t elapsed_us = 0;
+        while ( elapsed_us < interval.count() * 1000 )
+        {
+            const auto reads = sim_reads.load();
+            sim_time_us += safe.count() / 4;
+            elapsed_us  += safe.count() / 4;
+            for ( int i = 0; i < 10000 && sim_reads == reads; ++i )
+            {
+                std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+            }
+        }
+        guarded->read( end );
+        guarded->calc_energy_consumption( begin, end, delta );
+        CHECK( std::fabs( delta.energy_total - power * elapsed_us / 1e6 ) < 1e-6 * delta.energy_total );
+        guarded.reset();
+        sim_step_us   = 1000;
+        config.wrap_j = 0.;
+    }
+
+    // Sample with the measurement thread
+    {
+        std::vector<Metric> handles;
+        handles.emplace_back( Metric::Single(), rapl, rapl, "RAPL", 0, "COUNTER_0" );
+        handles.emplace_back( Metric::Single(), rapl, rapl, "RAPL", 1, "COUNTER_1" );
+        handles.emplace_back( Metric::DomainTotal(), rapl, rapl, "RAPL" );
+        handles.emplace_back( Metric::Total() );
+
+        MeasurementThread measurement( std::chrono::microseconds( 1000 ), {}, &steady_ticks );
+        measurement.start( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ), handles );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+        measurement.stop();
+
+        // Each read advances the simulated time by 1 ms
+        const auto& samples = measurement.samples();
+        const double power  = rapl_power( config );
+        CHECK( samples.size() > 5 );
+        double total = 0.;
+        for ( std::size_t row = 0; row < samples.size(); ++row )
+        {
+            CHECK( samples.value( row, 0 ) >= 0. );
+            CHECK( std::fabs( samples.value( row, 2 ) - samples.value( row, 3 ) ) < 1e-9 );
+            CHECK( std::fabs( samples.value( row, 3 ) - power * 1e-3 ) < 1e-9 );
+            total += samples.value( row, 3 );
+        }
+        CHECK( measurement.readings( handles[ 0 ] ).size() == samples.size() );
+
+        // The running statistics agree with the samples
+        const auto& stats = measurement.stats();
+        CHECK( std::fabs( stats[ 3 ].energy - total ) < 1e-6 * total );
+        CHECK( stats[ 3 ].min_power <= stats[ 3 ].energy / measurement.sampled_seconds() );
+        CHECK( stats[ 3 ].peak_power >= stats[ 3 ].energy / measurement.sampled_seconds() );
+        CHECK( measurement.sampled_seconds() > 0. );
+
+        // The readings stay after the samples are freed
+        const auto num_samples = samples.size();
+        measurement.release_samples();
+        CHECK( measurement.samples().size() == 0 && measurement.samples().bytes() == 0 );
+        CHECK( measurement.readings( handles[ 0 ] ).size() == num_samples );
+    }
+
+    // The sampler health metrics see the read latency of the backend
+    {
+        std::vector<Metric> handles;
+        handles.emplace_back( Metric::Plugin(), SamplerHealth::read_latency );
+        handles.emplace_back( Metric::Plugin(), SamplerHealth::sample_lateness );
+        handles.emplace_back( Metric::Plugin(), SamplerHealth::missed_ticks );
+        handles.emplace_back( Metric::Plugin(), SamplerHealth::buffer_bytes );
+        CHECK( handles[ 0 ].name() == "PLUGIN:read_latency" );
+        CHECK( handles[ 3 ].unit() == "B" );
+
+        config.read_latency = std::chrono::microseconds( 2000 );
+        MeasurementThread measurement( std::chrono::microseconds( 1000 ), {}, &steady_ticks );
+        measurement.start( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ), handles );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+        measurement.stop();
+        config.read_latency = std::chrono::microseconds( 0 );
+
+        const auto& samples = measurement.samples();
+        CHECK( samples.size() > 2 );
+        for ( std::size_t row = 1; row < samples.size(); ++row )
+        {
+            CHECK( samples.value( row, 0 ) >= 2e-3 );
+            // Reads take longer than the interval, so every sample is late
+            CHECK( samples.value( row, 1 ) > 0. );
+            CHECK( samples.value( row, 2 ) >= 0. );
+            CHECK( samples.value( row, 3 ) > 0. );
+        }
+    }
+    // The interval and the recorded domains change at runtime, each change is counted once
+    {
+        std::vector<Metric> handles;
+        handles.emplace_back( Metric::DomainTotal(), rapl, rapl, "RAPL" );
+        handles.emplace_back( Metric::Total() );
+        handles.emplace_back( Metric::Plugin(), SamplerHealth::reconfigured );
+        CHECK( handles[ 2 ].name() == "PLUGIN:reconfigured" );
+
+        MeasurementThread measurement( std::chrono::microseconds( 20000 ), {}, &steady_ticks );
+        measurement.limit_interval( std::chrono::microseconds( 30000 ) );
+        measurement.start( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ), handles );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+        const auto before = measurement.samples().size();
+        // Rejected above the limit, not counted
+        CHECK( !measurement.set_interval( std::chrono::microseconds( 40000 ) ) );
+        CHECK( !measurement.begin_burst( std::chrono::microseconds( 40000 ), std::chrono::microseconds( 0 ) ) );
+        CHECK( !measurement.begin_burst( std::chrono::microseconds( 0 ), std::chrono::microseconds( 0 ) ) );
+        CHECK( !measurement.begin_burst( std::chrono::microseconds( -1 ), std::chrono::microseconds( 0 ) ) );
+        CHECK( measurement.interval().count() == 20000 );
+        CHECK( measurement.set_interval( std::chrono::microseconds( 1000 ) ) );
+        std::vector<bool> disabled( rapl + 1, false );
+        disabled[ rapl ] = true;
+        measurement.mask_domains( disabled );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+        measurement.stop();
+
+        const auto& samples = measurement.samples();
+        CHECK( measurement.interval().count() == 1000 );
+        CHECK( samples.size() > before );
+        double reconfigurations = 0.;
+        bool   masked           = false;
+        for ( std::size_t row = 0; row < samples.size(); ++row )
+        {
+            reconfigurations += samples.value( row, 2 );
+            masked            = std::isnan( samples.value( row, 0 ) );
+            CHECK( samples.value( row, 1 ) >= 0. );
+        }
+        CHECK( reconfigurations == 2. );
+        CHECK( masked );
+        CHECK( !std::isnan( samples.value( 0, 0 ) ) );
+        // Masked samples do not count towards the energy of the domain
+        CHECK( measurement.stats()[ 0 ].energy < measurement.stats()[ 1 ].energy );
+    }
+
+    // Samples are stamped within the read. The sampler does one read before the first
+    // sample, so the first sample ends at least two read latencies after start().
+    for ( auto stamp_at : { MeasurementThread::StampAt::midpoint, MeasurementThread::StampAt::end } )
+    {
+        std::vector<Metric> handles;
+        handles.emplace_back( Metric::Total() );
+
+        config.read_latency = std::chrono::microseconds( 5000 );
+        MeasurementThread measurement( std::chrono::microseconds( 1000 ), {}, &steady_ticks );
+        measurement.stamp_at( stamp_at );
+        measurement.start( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ), handles );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 30 ) );
+        measurement.stop();
+        config.read_latency = std::chrono::microseconds( 0 );
+
+        CHECK( measurement.samples().size() > 0 );
+        const auto offset_ns = measurement.samples().timestamp( 0 ).count() - measurement.start_clock().ticks.count();
+        CHECK( offset_ns >= ( stamp_at == MeasurementThread::StampAt::end ? 10000000 : 7500000 ) );
+    }
+    // Raw stamps are mapped to the ticks of the timestamp source at stop()
+    {
+        std::vector<Metric> handles;
+        handles.emplace_back( Metric::Total() );
+
+        config.read_latency = std::chrono::microseconds( 5000 );
+        MeasurementThread measurement( std::chrono::microseconds( 1000 ), {}, &steady_ticks );
+        measurement.stamp_at( MeasurementThread::StampAt::end );
+        measurement.stamp_with_raw_clock( true );
+        measurement.start( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ), handles );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+        measurement.stop();
+        config.read_latency = std::chrono::microseconds( 0 );
+
+        const auto& samples = measurement.samples();
+        CHECK( samples.size() > 2 );
+        // Allow for 100 us of error of the mapping
+        CHECK( samples.timestamp( 0 ).count() >= measurement.start_clock().ticks.count() + 10000000 - 100000 );
+        CHECK( samples.timestamp( samples.size() - 1 ).count() <= measurement.stop_clock().ticks.count() + 100000 );
+        for ( std::size_t row = 1; row < samples.size(); ++row )
+        {
+            // Each read takes 5 ms
+            CHECK( samples.timestamp( row ).count() - samples.timestamp( row - 1 ).count() >= 5000000 - 100000 );
+        }
+    }
+    // The interval adapts to the counter update period measured at the start
+    for ( auto mode : { MeasurementThread::AutoInterval::clamp, MeasurementThread::AutoInterval::align } )
+    {
+        std::vector<Metric> handles;
+        handles.emplace_back( Metric::DomainTotal(), rapl, rapl, "RAPL" );
+
+        // The update period is measured in real time
+        config.refresh = std::chrono::milliseconds( 10 );
+        config.clock   = &std::chrono::steady_clock::now;
+        MeasurementThread measurement( std::chrono::microseconds( 1000 ), {}, &steady_ticks );
+        measurement.auto_interval( mode, std::chrono::milliseconds( 100 ) );
+        measurement.start( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ), handles );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 300 ) );
+        measurement.stop();
+        config.refresh = std::chrono::microseconds( 0 );
+        config.clock   = &sim_clock;
+
+        CHECK( measurement.interval() >= std::chrono::microseconds( 9000 ) );
+        CHECK( measurement.interval() <= std::chrono::microseconds( 12000 ) );
+        const auto& samples = measurement.samples();
+        CHECK( samples.size() >= 5 && samples.size() <= 30 );
+        std::size_t zeros = 0;
+        for ( std::size_t row = 0; row < samples.size(); ++row )
+        {
+            zeros += samples.value( row, 0 ) == 0.;
+        }
+        CHECK( zeros <= 3 );
+    }
+    // The first sample covers the calibration, so no energy is lost to it
+    {
+        std::vector<Metric> handles;
+        handles.emplace_back( Metric::Total() );
+
+        MeasurementThread measurement( std::chrono::microseconds( 1000 ), {}, &steady_ticks );
+        measurement.auto_interval( MeasurementThread::AutoInterval::clamp, std::chrono::milliseconds( 100 ) );
+        const double power   = rapl_power( config );
+        auto         backend = std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) );
+        const auto   before  = sim_reads.load();
+        measurement.start( std::move( backend ), handles );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 150 ) );
+        measurement.stop();
+
+        // Each read advances the simulated time by 1 ms, the energy spans all reads after the baseline
+        CHECK( measurement.sampled_seconds() >= 0.1 );
+        const double energy = measurement.stats()[ 0 ].energy;
+        const auto   reads  = sim_reads.load() - before;
+        CHECK( reads > 1 );
+        CHECK( std::fabs( energy - power * ( reads - 1 ) * 1e-3 ) < 1e-6 * energy );
+    }
+    // Only histograms, no samples
+    {
+        std::vector<Metric> handles;
+        handles.emplace_back( Metric::Total() );
+        handles.emplace_back( Metric::Plugin(), SamplerHealth::read_latency );
+
+        // The histograms are over the power in real time
+        config.clock = &std::chrono::steady_clock::now;
+        MeasurementThread measurement( std::chrono::microseconds( 1000 ), {}, &steady_ticks );
+        measurement.keep_histograms( true, false );
+        measurement.start( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ), handles );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+        measurement.stop();
+        config.clock = &sim_clock;
+
+        CHECK( measurement.samples().size() == 0 );
+        CHECK( measurement.samples_taken() > 5 );
+        CHECK( measurement.histograms().size() == 2 );
+        CHECK( std::fabs( measurement.histograms()[ 0 ].total() - measurement.sampled_seconds() ) < 1e-6 );
+        CHECK( measurement.histograms()[ 1 ].total() == 0. );
+        const double median = measurement.histograms()[ 0 ].percentile( 0.5 );
+        // 4 counters with 50 to 150 W each
+        CHECK( median >= 4 * 50. && median < 4 * 150. * ( 1. + 1. / 16. ) );
+    }
+
+    // Aligned samples fall on multiples of the interval in CLOCK_REALTIME
+    {
+        std::vector<Metric> handles;
+        handles.emplace_back( Metric::Total() );
+
+        MeasurementThread measurement( std::chrono::microseconds( 10000 ), {}, &steady_ticks );
+        measurement.align_phase_to_realtime( true );
+        measurement.start( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ), handles );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+        measurement.stop();
+
+        // The timestamps are steady clock ns, mapped to realtime with the start clock pair
+        const auto&         samples = measurement.samples();
+        const auto&         start   = measurement.start_clock();
+        std::vector<double> phases_us;
+        for ( std::size_t row = 1; row < samples.size(); ++row )
+        {
+            const auto realtime_ns = start.realtime_ns + ( samples.timestamp( row ).count() - start.ticks.count() );
+            phases_us.push_back( ( realtime_ns % 10000000 ) / 1e3 );
+        }
+        CHECK( phases_us.size() >= 5 );
+        std::sort( phases_us.begin(), phases_us.end() );
+        CHECK( phases_us[ phases_us.size() / 2 ] < 1000. );
+    }
+
+    // A measurement attached to a sampling daemon copies only the samples of its own run
+    {
+        std::vector<Metric> daemon_handles;
+        daemon_handles.emplace_back( Metric::Total() );
+        daemon_handles.emplace_back( Metric::DomainTotal(), rapl, rapl, "RAPL" );
+        const std::string ring_name = "/meric_test_daemon_" + std::to_string( getpid() );
+
+        MeasurementThread daemon( std::chrono::microseconds( 1000 ), {}, &steady_ticks );
+        daemon.keep_histograms( false, false );
+        daemon.publish_to( std::unique_ptr<TelemetryRingWriter>(
+                               new TelemetryRingWriter( ring_name, { "TOTAL:TOTAL", "RAPL:TOTAL" }, { "J", "J" }, 64, 1000 ) ) );
+        daemon.start( std::unique_ptr<EnergyBackend>( new SimBackend( { rapl }, config ) ), daemon_handles );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+
+        std::vector<Metric> handles;
+        handles.emplace_back( Metric::DomainTotal(), rapl, rapl, "RAPL" );
+        handles.emplace_back( Metric::Single(), rapl, rapl, "RAPL", 0, "COUNTER_0" );
+        handles.emplace_back( Metric::Plugin(), SamplerHealth::missed_ticks );
+        MeasurementThread measurement( std::chrono::microseconds( 1000 ), {}, &steady_ticks );
+        measurement.attach_to( std::unique_ptr<TelemetryRingReader>( new TelemetryRingReader( ring_name ) ) );
+        measurement.start( nullptr, handles );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+        measurement.stop();
+        std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+        daemon.stop();
+
+        // The ring of 64 slots is copied every 16 ms, so no sample is lost. Each read of
+        // the daemon advances the simulated time by 1 ms.
+        const auto&  samples = measurement.samples();
+        const double power   = rapl_power( config );
+        CHECK( samples.size() > 10 );
+        CHECK( measurement.missed_ticks() == 0 );
+        // The daemon does not record RAPL:COUNTER_0, which gets no column
+        CHECK( samples.num_metrics() == 2 );
+        CHECK( measurement.metrics().size() == 2 && measurement.metrics()[ 1 ] == &handles[ 2 ] );
+        CHECK( measurement.readings( handles[ 1 ] ).empty() );
+        double total = 0.;
+        for ( std::size_t row = 0; row < samples.size(); ++row )
+        {
+            CHECK( samples.timestamp( row ).count() >= measurement.start_clock().ticks.count() );
+            CHECK( samples.timestamp( row ).count() <= measurement.stop_clock().ticks.count() );
+            CHECK( samples.value( row, 1 ) == 0. );
+            CHECK( std::fabs( samples.value( row, 0 ) - power * 1e-3 ) < 1e-9 );
+            total += samples.value( row, 0 );
+        }
+        CHECK( std::fabs( measurement.stats()[ 0 ].energy - total ) < 1e-6 * total );
+    }
+    return 0;
+}
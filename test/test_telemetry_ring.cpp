@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Check the seqlock of the shared-memory telemetry ring: wrap-around and torn reads
+ */
+#include "TelemetryRing.h"
+#include "test_utils.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using namespace MericPlugin;
+
+
+int
+main()
+{
+    const std::string   name      = "/meric_test_ring_" + std::to_string( getpid() );
+    const std::uint64_t num_slots = 4;
+
+    TelemetryRingWriter writer( name, { "TOTAL:TOTAL", "PLUGIN:read_latency" }, { "J", "s" }, num_slots, 1000 );
+    TelemetryRingReader reader( name );
+    CHECK( reader.metric_names().size() == 2 && reader.metric_names()[ 1 ] == "PLUGIN:read_latency" );
+    CHECK( reader.metric_units().size() == 2 && reader.metric_units()[ 0 ] == "J" && reader.metric_units()[ 1 ] == "s" );
+    CHECK( reader.num_slots() == num_slots );
+    CHECK( reader.interval_us() == 1000 );
+    CHECK( reader.write_index() == 0 );
+
+    // Nothing is written yet
+    TelemetryRing::Sample sample;
+    CHECK( !reader.read( 0, sample ) );
+
+    // Only the last num_slots samples stay readable once the ring wraps around
+    for ( std::uint64_t index = 0; index < 10; ++index )
+    {
+        const double values[] = { double( index ), index * 1e-3 };
+        writer.publish( 1000 + index, 10, values );
+    }
+    CHECK( reader.write_index() == 10 );
+    for ( std::uint64_t index = 0; index < 10 - num_slots; ++index )
+    {
+        CHECK( !reader.read( index, sample ) );
+    }
+    for ( std::uint64_t index = 10 - num_slots; index < 10; ++index )
+    {
+        CHECK( reader.read( index, sample ) );
+        CHECK( sample.index == index && sample.timestamp_ns == 1000 + index && sample.duration_ns == 10 );
+        CHECK( sample.values.size() == 2 && sample.values[ 0 ] == double( index ) && sample.values[ 1 ] == index * 1e-3 );
+    }
+    CHECK( !reader.read( 10, sample ) );
+
+    // A slot with an odd sequence number is being written, reads of it fail until it is done
+    {
+        const int fd = shm_open( name.c_str(), O_RDWR, 0 );
+        CHECK( fd >= 0 );
+        const std::size_t size   = TelemetryRing::total_size( 2, num_slots );
+        void*             memory = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+        close( fd );
+        CHECK( memory != MAP_FAILED );
+        // The slots are at the end of the ring
+        auto* slot = reinterpret_cast<TelemetryRing::Slot*>( static_cast<unsigned char*>( memory ) + size
+                                                             - ( num_slots - 9 % num_slots ) * TelemetryRing::slot_size( 2 ) );
+        CHECK( reader.read( 9, sample ) );
+        slot->sequence = 2 * 9 + 1;
+        CHECK( !reader.read( 9, sample ) );
+        // Index 13 overwriting index 9
+        slot->sequence = 2 * 13 + 1;
+        CHECK( !reader.read( 9, sample ) );
+        CHECK( !reader.read( 13, sample ) );
+        slot->sequence = 2 * 9 + 2;
+        CHECK( reader.read( 9, sample ) );
+        munmap( memory, size );
+    }
+
+    // A reader racing with the writer only accepts complete samples. Many metrics make
+    // the copy long enough to be overwritten now and then.
+    {
+        const std::vector<std::string> names( 512, "TOTAL:TOTAL" );
+        const std::vector<std::string> units( names.size(), "J" );
+        TelemetryRingWriter            wide_writer( name + "_wide", names, units, num_slots, 1000 );
+        TelemetryRingReader            wide_reader( name + "_wide" );
+        std::atomic<bool>              stop( false );
+        std::thread                    publisher( [ & ](){
+                std::vector<double> values( names.size() );
+                for ( std::uint64_t index = 0; !stop; ++index )
+                {
+                    std::fill( values.begin(), values.end(), double( index ) );
+                    wide_writer.publish( index, index, values.data() );
+                }
+            } );
+        std::uint64_t accepted = 0;
+        bool          torn     = false;
+        for ( long attempt = 0; attempt < 100000000 && accepted < 100000; ++attempt )
+        {
+            // The oldest sample, whose slot the writer overwrites next
+            const std::uint64_t end = wide_reader.write_index();
+            if ( end < num_slots || !wide_reader.read( end - num_slots, sample ) )
+            {
+                continue;
+            }
+            ++accepted;
+            torn = torn || sample.timestamp_ns != end - num_slots || sample.duration_ns != sample.timestamp_ns
+                   || std::count( sample.values.begin(), sample.values.end(), double( sample.timestamp_ns ) ) != long( names.size() );
+        }
+        stop = true;
+        publisher.join();
+        CHECK( !torn );
+        CHECK( accepted == 100000 );
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: (c) 2025 Forschungszentrum Jülich GmbH <fz-juelich.de>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Helpers shared by the unit tests
+ */
+#pragma once
+
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+#define CHECK( condition ) \
+    if ( !( condition ) ) \
+    { \
+        std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+        return 1; \
+    }
+
+
+namespace MericPlugin
+{
+namespace test
+{
+inline void
+write_file( const std::string& path, const std::string& content )
+{
+    std::ofstream( path ) << content << "\n";
+}
+
+
+/*
+ * A fresh directory below /tmp that is removed with everything in it when the object goes out of scope
+ */
+class TempDir
+{
+public:
+    explicit
+    TempDir( const std::string& prefix )
+    {
+        const std::string name = "/tmp/" + prefix + "_XXXXXX";
+        std::vector<char> buffer( name.begin(), name.end() );
+        buffer.push_back( '\0' );
+        if ( mkdtemp( buffer.data() ) == nullptr )
+        {
+            throw std::runtime_error( "Cannot create a temporary directory for " + prefix );
+        }
+        dir = buffer.data();
+    }
+
+    ~TempDir()
+    {
+        nftw( dir.c_str(), []( const char* path, const struct stat*, int, struct FTW* ){
+                return remove( path );
+            }, 16, FTW_DEPTH | FTW_PHYS );
+    }
+
+    TempDir( const TempDir& )            = delete;
+    TempDir& operator=( const TempDir& ) = delete;
+
+    const std::string&
+    path() const
+    {
+        return dir;
+    }
+
+private:
+    std::string dir;
+};
+}
+}